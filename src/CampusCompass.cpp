@@ -1,4 +1,6 @@
 #include "CampusCompass.h"
+#include "MemoryUsage.h"
+#include "Tracer.h"
 
 #include <fstream>
 #include <sstream>
@@ -7,11 +9,19 @@
 #include <algorithm>
 #include <unordered_set>
 #include <limits>
+#include <charconv>
+#include <iterator>
+#include <functional>
+#include <exception>
 
 // -----------------------------
 // Constructor
 // -----------------------------
-CampusCompass::CampusCompass() {}
+CampusCompass::CampusCompass() : out_(&std::cout) {}
+
+void CampusCompass::SetOutput(std::ostream& out) {
+    out_ = &out;
+}
 
 // -----------------------------
 // Validation Helpers
@@ -47,6 +57,19 @@ bool CampusCompass::isValidClassCode(const std::string& code) const {
     return true;
 }
 
+// Everything insert/loadStudents require of a new record except
+// uniqueness of the UFID (StudentManager::addStudent checks that)
+bool CampusCompass::isValidStudent(const Student& s) const {
+    if (s.classes.size() < 1 || s.classes.size() > 6) return false;
+    if (!isValidName(s.name) || !isValidUFID(s.ufid)) return false;
+
+    for (const auto& c : s.classes) {
+        if (!isValidClassCode(c)) return false;
+        if (!catalog_.hasClass(c)) return false;
+    }
+    return true;
+}
+
 // -----------------------------
 // "HH:MM" → minutes
 // -----------------------------
@@ -58,9 +81,10 @@ int CampusCompass::parseTimeToMinutes(const std::string& t) const {
 }
 
 // -----------------------------
-// CSV Loader: edges.csv
+// CSV Reader: edges.csv
 // -----------------------------
-bool CampusCompass::loadEdges(const std::string& path) {
+bool CampusCompass::readEdges(const std::string& path,
+                              std::vector<Graph::EdgeRow>& rows) const {
     std::ifstream file(path);
     if (!file.is_open()) return false;
 
@@ -83,15 +107,16 @@ bool CampusCompass::loadEdges(const std::string& path) {
         int id2 = std::stoi(id2Str);
         int time = std::stoi(timeStr);
 
-        graph_.addEdge(id1, id2, time);
+        rows.emplace_back(id1, id2, time);
     }
     return true;
 }
 
 // -----------------------------
-// CSV Loader: classes.csv
+// CSV Reader: classes.csv
 // -----------------------------
-bool CampusCompass::loadClasses(const std::string& path) {
+bool CampusCompass::readClasses(const std::string& path,
+                                std::vector<ClassInfo>& classes) const {
     std::ifstream file(path);
     if (!file.is_open()) return false;
 
@@ -115,25 +140,132 @@ bool CampusCompass::loadClasses(const std::string& path) {
         info.startMinutes = parseTimeToMinutes(startStr);
         info.endMinutes = parseTimeToMinutes(endStr);
 
-        catalog_.addClass(info);
+        classes.push_back(info);
     }
     return true;
 }
 
+// -----------------------------
+// CSV Loaders
+// -----------------------------
+bool CampusCompass::loadEdges(const std::string& path) {
+    std::vector<Graph::EdgeRow> rows;
+    bool ok = readEdges(path, rows);
+    for (const auto& [u, v, w] : rows) {
+        graph_.addEdge(u, v, w);
+    }
+    graph_.reorder();
+    return ok;
+}
+
+bool CampusCompass::loadClasses(const std::string& path) {
+    std::vector<ClassInfo> classes;
+    bool ok = readClasses(path, classes);
+    for (const auto& info : classes) {
+        catalog_.addClass(info);
+    }
+    return ok;
+}
+
 // -----------------------------
 // Public CSV Loader (called by main)
 // -----------------------------
 bool CampusCompass::ParseCSV(const std::string& edges_filepath,
                              const std::string& classes_filepath) {
+    edgesPath_ = edges_filepath;
+    classesPath_ = classes_filepath;
     bool ok1 = loadEdges(edges_filepath);
     bool ok2 = loadClasses(classes_filepath);
     return ok1 && ok2;
 }
 
+// -----------------------------
+// Travel time cache
+// -----------------------------
+const std::unordered_map<int, int>& CampusCompass::distancesFrom(int source) const {
+    if (distCacheVersion_ != graph_.version()) {
+        distCache_.clear();
+        distCacheEntries_ = 0;
+        distCacheVersion_ = graph_.version();
+    }
+
+    auto it = distCache_.find(source);
+    if (it != distCache_.end()) {
+        return it->second;
+    }
+
+    std::unordered_map<int, int> parent;
+    std::unordered_map<int, int> dist;
+    graph_.dijkstra(source, dist, parent);
+
+    if (distCacheEntries_ + dist.size() > kMaxCachedEntries) {
+        distCache_.clear();
+        distCacheEntries_ = 0;
+    }
+    distCacheEntries_ += dist.size();
+    return distCache_.emplace(source, std::move(dist)).first->second;
+}
+
+int CampusCompass::travelTime(int from, int to) const {
+    const auto& dist = distancesFrom(from);
+    auto it = dist.find(to);
+    if (it == dist.end()) {
+        return std::numeric_limits<int>::max();
+    }
+    return it->second;
+}
+
+// -----------------------------
+// Hot reload: apply only what changed on disk
+// -----------------------------
+bool CampusCompass::Reload(const std::string& edges_filepath,
+                           const std::string& classes_filepath) {
+    // Read both files completely before touching anything, so a bad file
+    // leaves the loaded data as it was.
+    std::vector<Graph::EdgeRow> rows;
+    std::vector<ClassInfo> classes;
+    try {
+        if (!readEdges(edges_filepath, rows)) return false;
+        if (!readClasses(classes_filepath, classes)) return false;
+    } catch (const std::exception&) {
+        return false;  // malformed number
+    }
+
+    // Dependent state: the travel time cache is keyed on graph_.version()
+    // and the catalog keeps its own indexes in step, so nothing else needs
+    // invalidating. Students keep their class lists even if a class is
+    // gone from the catalog; queries already treat unknown codes as such.
+    if (graph_.syncEdges(rows) > 0) {
+        graph_.reorder();  // new vertices were appended at the end
+    }
+    catalog_.syncClasses(classes);
+
+    edgesPath_ = edges_filepath;
+    classesPath_ = classes_filepath;
+    return true;
+}
+
 // -----------------------------
 // handleInsert: parses full line with quoted name
 // -----------------------------
 bool CampusCompass::handleInsert(const std::string& fullLine) {
+    Student s;
+    {
+        TraceSpan span("parse");
+        if (!parseInsert(fullLine, s)) {
+            return false;
+        }
+    }
+
+    // Validation
+    if (!isValidStudent(s)) {
+        return false;
+    }
+
+    return students_.addStudent(s);
+}
+
+bool CampusCompass::parseInsert(const std::string& fullLine, Student& s) const {
     // Find first and second quote
     std::size_t firstQuote = fullLine.find('"');
     std::size_t secondQuote = fullLine.find('"', firstQuote + 1);
@@ -168,30 +300,81 @@ bool CampusCompass::handleInsert(const std::string& fullLine) {
         return false;
     }
 
-    // Validation
-    if (!isValidName(name) || !isValidUFID(ufid)) {
-        return false;
-    }
-    if (students_.hasStudent(ufid)) {
+    s.name = name;
+    s.ufid = ufid;
+    s.residenceLocationId = residenceId;
+    s.classes = codes;
+    return true;
+}
+
+// -----------------------------
+// Roster loader: one student per row
+// -----------------------------
+bool CampusCompass::LoadStudents(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        *out_ << "unsuccessful\n";
         return false;
     }
 
-    for (const auto& c : codes) {
-        if (!isValidClassCode(c)) {
-            return false;
+    // Read the whole roster at once and split it in place; going through
+    // getline + stringstream per field dominates on large rosters.
+    std::string data((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+
+    std::size_t rows = static_cast<std::size_t>(std::count(data.begin(), data.end(), '\n'));
+    students_.reserve(rows);
+
+    int loaded = 0;
+    int lineNo = 0;
+    std::size_t pos = 0;
+    std::vector<std::string> fields;
+
+    while (pos < data.size()) {
+        std::size_t eol = data.find('\n', pos);
+        if (eol == std::string::npos) eol = data.size();
+        std::size_t end = eol;
+        if (end > pos && data[end - 1] == '\r') --end;
+
+        std::size_t lineStart = pos;
+        pos = eol + 1;
+        ++lineNo;
+
+        if (lineNo == 1 || end == lineStart) continue;  // header / blank
+
+        fields.clear();
+        std::size_t f = lineStart;
+        while (true) {
+            std::size_t comma = data.find(',', f);
+            if (comma == std::string::npos || comma > end) comma = end;
+            fields.emplace_back(data, f, comma - f);
+            if (comma == end) break;
+            f = comma + 1;
         }
-        if (!catalog_.hasClass(c)) {
-            return false;
+
+        bool ok = fields.size() >= 4;
+        Student s;
+        if (ok) {
+            s.name = fields[0];
+            s.ufid = fields[1];
+
+            const std::string& res = fields[2];
+            auto [ptr, ec] = std::from_chars(res.data(), res.data() + res.size(),
+                                             s.residenceLocationId);
+            ok = (ec == std::errc() && ptr == res.data() + res.size());
+
+            s.classes.assign(fields.begin() + 3, fields.end());
         }
-    }
 
-    Student s;
-    s.name = name;
-    s.ufid = ufid;
-    s.residenceLocationId = residenceId;
-    s.classes = codes;
+        if (ok && isValidStudent(s) && students_.addStudent(s)) {
+            ++loaded;
+        } else {
+            *out_ << "Row " << lineNo << ": unsuccessful\n";
+        }
+    }
 
-    return students_.addStudent(s);
+    *out_ << loaded << "\n";
+    return true;
 }
 
 // -----------------------------
@@ -200,14 +383,12 @@ bool CampusCompass::handleInsert(const std::string& fullLine) {
 void CampusCompass::handlePrintShortestEdges(const std::string& ufid) const {
     const Student* s = students_.getStudent(ufid);
     if (!s) {
-        std::cout << "unsuccessful\n";
+        *out_ << "unsuccessful\n";
         return;
     }
 
-    // Run Dijkstra from residence
-    std::unordered_map<int, int> dist;
-    std::unordered_map<int, int> parent;
-    graph_.dijkstra(s->residenceLocationId, dist, parent);
+    // Distances from residence
+    const auto& dist = distancesFrom(s->residenceLocationId);
 
     const int INF = std::numeric_limits<int>::max();
 
@@ -215,13 +396,14 @@ void CampusCompass::handlePrintShortestEdges(const std::string& ufid) const {
     std::vector<std::string> codes = s->classes;
     std::sort(codes.begin(), codes.end());
 
-    std::cout << "Name: " << s->name << "\n";
+    TraceSpan span("output");
+    *out_ << "Name: " << s->name << "\n";
 
     for (const auto& code : codes) {
         const ClassInfo* ci = catalog_.getClass(code);
         if (!ci) {
             // If the class doesn't exist in catalog treat as unreachable
-            std::cout << code << " | Total Time: -1\n";
+            *out_ << code << " | Total Time: -1\n";
             continue;
         }
         int loc = ci->locationId;
@@ -232,7 +414,7 @@ void CampusCompass::handlePrintShortestEdges(const std::string& ufid) const {
             totalTime = it->second;
         }
 
-        std::cout << code << " | Total Time: " << totalTime << "\n";
+        *out_ << code << " | Total Time: " << totalTime << "\n";
     }
 }
 
@@ -242,7 +424,7 @@ void CampusCompass::handlePrintShortestEdges(const std::string& ufid) const {
 void CampusCompass::handlePrintStudentZone(const std::string& ufid) const {
     const Student* s = students_.getStudent(ufid);
     if (!s) {
-        std::cout << "unsuccessful\n";
+        *out_ << "unsuccessful\n";
         return;
     }
 
@@ -257,28 +439,31 @@ void CampusCompass::handlePrintStudentZone(const std::string& ufid) const {
     std::unordered_set<int> vertexSet;
     vertexSet.insert(s->residenceLocationId);
 
-    for (const auto& code : s->classes) {
-        const ClassInfo* ci = catalog_.getClass(code);
-        if (!ci) continue;
+    {
+        TraceSpan span("pathReconstruction");
+        for (const auto& code : s->classes) {
+            const ClassInfo* ci = catalog_.getClass(code);
+            if (!ci) continue;
 
-        int loc = ci->locationId;
+            int loc = ci->locationId;
 
-        auto it = dist.find(loc);
-        if (it == dist.end() || it->second == INF) {
-            // class unreachable: skip
-            continue;
-        }
-
-        // Reconstruct path from class location back to residence
-        int curr = loc;
-        while (curr != -1) {
-            if (!vertexSet.insert(curr).second) {
-                curr = parent[curr];
+            auto it = dist.find(loc);
+            if (it == dist.end() || it->second == INF) {
+                // class unreachable: skip
                 continue;
             }
-            auto pit = parent.find(curr);
-            if (pit == parent.end()) break;
-            curr = pit->second;
+
+            // Reconstruct path from class location back to residence
+            int curr = loc;
+            while (curr != -1) {
+                if (!vertexSet.insert(curr).second) {
+                    curr = parent[curr];
+                    continue;
+                }
+                auto pit = parent.find(curr);
+                if (pit == parent.end()) break;
+                curr = pit->second;
+            }
         }
     }
 
@@ -288,7 +473,8 @@ void CampusCompass::handlePrintStudentZone(const std::string& ufid) const {
     // MST on induced subgraph
     int cost = graph_.mstCost(vertices);
 
-    std::cout << "Student Zone Cost For " << s->name << ": " << cost << "\n";
+    TraceSpan span("output");
+    *out_ << "Student Zone Cost For " << s->name << ": " << cost << "\n";
 }
 
 // -----------------------------
@@ -297,12 +483,12 @@ void CampusCompass::handlePrintStudentZone(const std::string& ufid) const {
 void CampusCompass::handleVerifySchedule(const std::string& ufid) const {
     const Student* s = students_.getStudent(ufid);
     if (!s) {
-        std::cout << "unsuccessful\n";
+        *out_ << "unsuccessful\n";
         return;
     }
 
     if (s->classes.size() <= 1) {
-        std::cout << "unsuccessful\n";
+        *out_ << "unsuccessful\n";
         return;
     }
 
@@ -321,7 +507,7 @@ void CampusCompass::handleVerifySchedule(const std::string& ufid) const {
     }
 
     if (sc.size() <= 1) {
-        std::cout << "unsuccessful\n";
+        *out_ << "unsuccessful\n";
         return;
     }
 
@@ -329,7 +515,7 @@ void CampusCompass::handleVerifySchedule(const std::string& ufid) const {
         return a.start < b.start;
     });
 
-    std::cout << "Schedule Check for " << s->name << ":\n";
+    *out_ << "Schedule Check for " << s->name << ":\n";
 
     const int INF = std::numeric_limits<int>::max();
 
@@ -340,114 +526,323 @@ void CampusCompass::handleVerifySchedule(const std::string& ufid) const {
         int gap = c2.start - c1.end;
 
         // Shortest path from c1.locationId to c2.locationId
-        std::unordered_map<int, int> dist;
-        std::unordered_map<int, int> parent;
-        graph_.dijkstra(c1.locationId, dist, parent);
-
-        int travel = INF;
-        auto it = dist.find(c2.locationId);
-        if (it != dist.end()) {
-            travel = it->second;
-        }
+        int travel = travelTime(c1.locationId, c2.locationId);
 
         bool canMake = (travel != INF && gap >= travel);
 
-        std::cout << c1.code << " - " << c2.code << " ";
+        *out_ << c1.code << " - " << c2.code << " ";
         if (canMake) {
-            std::cout << "Can make it!\n";
+            *out_ << "Can make it!\n";
         } else {
-            std::cout << "Cannot make it!\n";
+            *out_ << "Cannot make it!\n";
         }
     }
 }
 
 // -----------------------------
-// Main command parser
+// reachableWithin helper
 // -----------------------------
-bool CampusCompass::ParseCommand(const std::string& command) {
-    if (command.empty()) {
-        std::cout << "unsuccessful\n";
-        return false;
+void CampusCompass::handleReachableWithin(int source,
+                                          const std::vector<int>& budgets) const {
+    if (budgets.empty() || !graph_.hasVertex(source)) {
+        *out_ << "unsuccessful\n";
+        return;
+    }
+    int maxBudget = *std::max_element(budgets.begin(), budgets.end());
+    if (*std::min_element(budgets.begin(), budgets.end()) < 0) {
+        *out_ << "unsuccessful\n";
+        return;
     }
 
-    std::stringstream ss(command);
-    std::string cmd;
-    ss >> cmd;
+    // One bounded sweep for the largest budget answers all of them
+    std::unordered_map<int, int> dist;
+    graph_.reachableWithin(source, maxBudget, dist);
+
+    std::vector<std::pair<int, int>> reached(dist.begin(), dist.end());  // (node, time), by node
+    std::sort(reached.begin(), reached.end());
+
+    for (int budget : budgets) {
+        std::vector<std::string> codes;
+
+        *out_ << "Locations Within " << budget << ":";
+        for (const auto& [loc, t] : reached) {
+            if (t > budget) continue;
+            *out_ << " " << loc;
+            if (const auto* here = catalog_.classesAt(loc)) {
+                codes.insert(codes.end(), here->begin(), here->end());
+            }
+        }
+        *out_ << "\n";
+
+        std::sort(codes.begin(), codes.end());
+        *out_ << "Classes Within " << budget << ":";
+        for (const auto& code : codes) {
+            *out_ << " " << code;
+        }
+        *out_ << "\n";
+    }
+}
+
+// -----------------------------
+// findCompatibleClasses helper
+// -----------------------------
+// Lists catalog classes the student doesn't take that fit into a gap of
+// their schedule: reachable from the previous class before they start,
+// and ending early enough to reach the next class in time.
+void CampusCompass::handleFindCompatibleClasses(const std::string& ufid) const {
+    const Student* s = students_.getStudent(ufid);
+    if (!s) {
+        *out_ << "unsuccessful\n";
+        return;
+    }
+
+    std::vector<const ClassInfo*> sched;
+    for (const auto& code : s->classes) {
+        const ClassInfo* ci = catalog_.getClass(code);
+        if (ci) sched.push_back(ci);
+    }
+    std::sort(sched.begin(), sched.end(), [](const ClassInfo* a, const ClassInfo* b) {
+        return a->startMinutes < b->startMinutes;
+    });
+
+    const int INF = std::numeric_limits<int>::max();
+    const int kEndOfDay = 24 * 60;
+
+    std::vector<std::string> found;
+
+    // Gap i lies between the class ending last among sched[0..i-1] and
+    // sched[i]; the first and last gaps are open on one side. Tracking the
+    // latest end (not just sched[i - 1]) keeps a long class from being
+    // hidden by a shorter one that starts after it.
+    const ClassInfo* prev = nullptr;
+    for (std::size_t i = 0; i <= sched.size(); ++i) {
+        if (i > 0 && (!prev || sched[i - 1]->endMinutes > prev->endMinutes)) {
+            prev = sched[i - 1];
+        }
+        const ClassInfo* next = (i == sched.size()) ? nullptr : sched[i];
+
+        int lo = prev ? prev->endMinutes : 0;
+        int hi = next ? next->startMinutes : kEndOfDay;
+        if (lo > hi) continue;  // overlapping classes leave no gap
+
+        for (const ClassInfo* c : catalog_.classesStartingBetween(lo, hi)) {
+            if (next && c->endMinutes > next->startMinutes) continue;
+            if (std::find(s->classes.begin(), s->classes.end(), c->code) != s->classes.end()) {
+                continue;
+            }
+            if (prev) {
+                int t = travelTime(prev->locationId, c->locationId);
+                if (t == INF || c->startMinutes - prev->endMinutes < t) continue;
+            }
+            if (next) {
+                int t = travelTime(next->locationId, c->locationId);
+                if (t == INF || next->startMinutes - c->endMinutes < t) continue;
+            }
+            found.push_back(c->code);
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    *out_ << "Compatible Classes for " << s->name << ":\n";
+    for (const auto& code : found) {
+        *out_ << code << "\n";
+    }
+}
+
+// -----------------------------
+// suggestSchedule helper
+// -----------------------------
+// options[i] lists the interchangeable classes for course i. Picks one
+// class per course so that, walked in start-time order from the student's
+// residence, every class can be reached before it starts, minimizing the
+// total walking time.
+void CampusCompass::handleSuggestSchedule(
+        const std::string& ufid,
+        const std::vector<std::vector<std::string>>& options) const {
+    const Student* s = students_.getStudent(ufid);
+    if (!s || options.empty() || options.size() > 6) {
+        *out_ << "unsuccessful\n";
+        return;
+    }
+
+    struct Candidate {
+        const ClassInfo* info;
+        int course;
+    };
+
+    std::vector<Candidate> cands;
+    for (std::size_t i = 0; i < options.size(); ++i) {
+        for (const auto& code : options[i]) {
+            const ClassInfo* ci = catalog_.getClass(code);
+            if (!isValidClassCode(code) || !ci) {
+                *out_ << "unsuccessful\n";
+                return;
+            }
+            cands.push_back({ci, static_cast<int>(i)});
+        }
+    }
+
+    // Schedules are built in start-time order, so later candidates only
+    // need to be considered after the last class picked.
+    std::sort(cands.begin(), cands.end(), [](const Candidate& a, const Candidate& b) {
+        return a.info->startMinutes < b.info->startMinutes;
+    });
+
+    const int INF = std::numeric_limits<int>::max();
+    const int n = static_cast<int>(cands.size());
+    const int allCourses = (1 << options.size()) - 1;
+
+    // Travel times between candidates, plus from residence (index n)
+    std::vector<std::vector<int>> travel(n + 1, std::vector<int>(n, INF));
+    for (int i = 0; i <= n; ++i) {
+        int from = (i == n) ? s->residenceLocationId : cands[i].info->locationId;
+        for (int j = 0; j < n; ++j) {
+            travel[i][j] = travelTime(from, cands[j].info->locationId);
+        }
+    }
+
+    // best[mask][last]: cheapest walk seen that covers 'mask' courses and
+    // ends at candidate 'last'; a later branch reaching the same state at
+    // no lower cost can't do better and is pruned.
+    std::vector<std::vector<int>> best(allCourses + 1, std::vector<int>(n, INF));
+
+    int bestCost = INF;
+    std::vector<int> path, bestPath;
+
+    std::function<void(int, int, int)> search = [&](int mask, int last, int cost) {
+        if (mask == allCourses) {
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestPath = path;
+            }
+            return;
+        }
+        int from = (last == -1) ? n : last;
+
+        for (int j = (last == -1) ? 0 : last + 1; j < n; ++j) {
+            const Candidate& c = cands[j];
+            if (mask & (1 << c.course)) continue;
+
+            int t = travel[from][j];
+            if (t == INF) continue;
+            if (last != -1 &&
+                c.info->startMinutes - cands[last].info->endMinutes < t) {
+                continue;
+            }
+
+            int next = cost + t;
+            int nextMask = mask | (1 << c.course);
+            if (next >= bestCost || next >= best[nextMask][j]) continue;
+            best[nextMask][j] = next;
+
+            path.push_back(j);
+            search(nextMask, j, next);
+            path.pop_back();
+        }
+    };
+    search(0, -1, 0);
+
+    if (bestCost == INF) {
+        *out_ << "unsuccessful\n";
+        return;
+    }
+
+    *out_ << "Suggested Schedule for " << s->name << ":\n";
+    for (int j : bestPath) {
+        *out_ << cands[j].info->code << "\n";
+    }
+    *out_ << "Total Walking Time: " << bestCost << "\n";
+}
+
+// -----------------------------
+// Mutation batches
+// -----------------------------
+bool CampusCompass::isMutation(const std::string& cmd) {
+    return cmd == "insert" || cmd == "remove" || cmd == "dropClass" ||
+           cmd == "replaceClass" || cmd == "removeClass" ||
+           cmd == "toggleEdgesClosure";
+}
 
+// Run one mutation and print its result line; returns whether it applied
+bool CampusCompass::applyMutation(const std::string& cmd,
+                                  std::stringstream& ss,
+                                  const std::string& command) {
     if (cmd == "insert") {
         bool ok = handleInsert(command);
-        std::cout << (ok ? "successful\n" : "unsuccessful\n");
-        return true;
+        *out_ << (ok ? "successful\n" : "unsuccessful\n");
+        return ok;
     }
-    else if (cmd == "remove") {
+    if (cmd == "remove") {
         std::string ufid;
         if (!(ss >> ufid)) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
         if (!isValidUFID(ufid)) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
         bool ok = students_.removeStudent(ufid);
-        std::cout << (ok ? "successful\n" : "unsuccessful\n");
-        return true;
+        *out_ << (ok ? "successful\n" : "unsuccessful\n");
+        return ok;
     }
-    else if (cmd == "dropClass") {
+    if (cmd == "dropClass") {
         std::string ufid, code;
         if (!(ss >> ufid >> code)) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
         if (!isValidUFID(ufid) || !isValidClassCode(code) || !catalog_.hasClass(code)) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
         bool ok = students_.dropClass(ufid, code);
-        std::cout << (ok ? "successful\n" : "unsuccessful\n");
-        return true;
+        *out_ << (ok ? "successful\n" : "unsuccessful\n");
+        return ok;
     }
-    else if (cmd == "replaceClass") {
+    if (cmd == "replaceClass") {
         std::string ufid, c1, c2;
         if (!(ss >> ufid >> c1 >> c2)) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
         if (!isValidUFID(ufid) ||
             !isValidClassCode(c1) ||
             !isValidClassCode(c2) ||
             !catalog_.hasClass(c2)) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
         if (!catalog_.hasClass(c1)) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
 
         bool ok = students_.replaceClass(ufid, c1, c2);
-        std::cout << (ok ? "successful\n" : "unsuccessful\n");
-        return true;
+        *out_ << (ok ? "successful\n" : "unsuccessful\n");
+        return ok;
     }
-    else if (cmd == "removeClass") {
+    if (cmd == "removeClass") {
         std::string code;
         if (!(ss >> code)) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
         if (!isValidClassCode(code)) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
         int count = students_.removeClassFromAll(code);
-        std::cout << count << "\n";
+        *out_ << count << "\n";
         return true;
     }
-    else if (cmd == "toggleEdgesClosure") {
+    if (cmd == "toggleEdgesClosure") {
         int N;
         if (!(ss >> N) || N < 0) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
         std::vector<int> ids;
         int x;
@@ -455,45 +850,161 @@ bool CampusCompass::ParseCommand(const std::string& command) {
             ids.push_back(x);
         }
         if (static_cast<int>(ids.size()) != 2 * N) {
-            std::cout << "unsuccessful\n";
-            return true;
+            *out_ << "unsuccessful\n";
+            return false;
         }
+        std::vector<std::pair<int, int>> pairs;
+        pairs.reserve(N);
         for (int i = 0; i < 2 * N; i += 2) {
-            int u = ids[i];
-            int v = ids[i + 1];
-            graph_.toggleEdge(u, v);
+            pairs.emplace_back(ids[i], ids[i + 1]);
         }
-        std::cout << "successful\n";
+        graph_.toggleEdges(pairs);
+        *out_ << "successful\n";
+        return true;
+    }
+    return false;
+}
+
+bool CampusCompass::commitBatch() {
+    std::vector<std::pair<std::string, std::string>> staged = std::move(staged_);
+    staged_.clear();
+    inBatch_ = false;
+
+    // Undo state: one copy of the student table per batch, and the edge
+    // toggles applied so far (a toggle is its own inverse).
+    bool touchesStudents = std::any_of(staged.begin(), staged.end(), [](const auto& m) {
+        return m.first != "toggleEdgesClosure";
+    });
+    StudentManager savedStudents;
+    if (touchesStudents) {
+        savedStudents = students_;
+    }
+    std::vector<std::size_t> applied;
+
+    // Run each mutation with its output captured and discarded; the first
+    // one that reports failure aborts the batch.
+    // Derived state stays lazy while this runs: the travel time cache is
+    // only dropped on the next query and the catalog index is untouched,
+    // so the batch pays for them once rather than per mutation.
+    std::ostream* out = out_;
+    std::ostringstream result;
+    out_ = &result;
+
+    bool ok = true;
+    for (std::size_t i = 0; i < staged.size(); ++i) {
+        std::stringstream ss(staged[i].second);
+        std::string cmd;
+        ss >> cmd;
+        if (!applyMutation(cmd, ss, staged[i].second)) {
+            ok = false;
+            break;
+        }
+        if (staged[i].first == "toggleEdgesClosure") {
+            applied.push_back(i);
+        }
+    }
+
+    if (!ok) {
+        if (touchesStudents) {
+            students_ = std::move(savedStudents);
+        }
+        for (auto it = applied.rbegin(); it != applied.rend(); ++it) {
+            std::stringstream ss(staged[*it].second);
+            std::string cmd;
+            ss >> cmd;
+            applyMutation(cmd, ss, staged[*it].second);
+        }
+    }
+
+    out_ = out;
+    return ok;
+}
+
+// -----------------------------
+// Main command parser
+// -----------------------------
+bool CampusCompass::ParseCommand(const std::string& command) {
+    TraceCommand trace;
+
+    if (command.empty()) {
+        *out_ << "unsuccessful\n";
+        return false;
+    }
+
+    std::stringstream ss(command);
+    std::string cmd;
+    ss >> cmd;
+    trace.setName(cmd);
+
+    if (inBatch_ && isMutation(cmd)) {
+        staged_.emplace_back(cmd, command);
+        return true;
+    }
+    // Loads replace state wholesale and can't be undone; not inside a batch
+    if (inBatch_ && (cmd == "loadStudents" || cmd == "reload")) {
+        *out_ << "unsuccessful\n";
+        return true;
+    }
+    if (cmd == "begin") {
+        bool ok = !inBatch_;
+        inBatch_ = true;
+        *out_ << (ok ? "successful\n" : "unsuccessful\n");
+        return true;
+    }
+    if (cmd == "commit") {
+        bool ok = inBatch_ && commitBatch();
+        *out_ << (ok ? "successful\n" : "unsuccessful\n");
+        return true;
+    }
+    if (cmd == "rollback") {
+        bool ok = inBatch_;
+        inBatch_ = false;
+        staged_.clear();
+        *out_ << (ok ? "successful\n" : "unsuccessful\n");
+        return true;
+    }
+
+    if (isMutation(cmd)) {
+        applyMutation(cmd, ss, command);
+        return true;
+    }
+    else if (cmd == "loadStudents") {
+        std::string path;
+        if (!(ss >> path)) {
+            *out_ << "unsuccessful\n";
+            return true;
+        }
+        LoadStudents(path);
         return true;
     }
     else if (cmd == "checkEdgeStatus") {
         int u, v;
         if (!(ss >> u >> v)) {
-            std::cout << "unsuccessful\n";
+            *out_ << "unsuccessful\n";
             return true;
         }
         std::string status = graph_.edgeStatus(u, v);
-        std::cout << status << "\n";
+        *out_ << status << "\n";
         return true;
     }
     else if (cmd == "isConnected") {
         int u, v;
         if (!(ss >> u >> v)) {
-            std::cout << "unsuccessful\n";
+            *out_ << "unsuccessful\n";
             return true;
         }
         bool ok = graph_.isConnected(u, v);
-        std::cout << (ok ? "successful\n" : "unsuccessful\n");
+        *out_ << (ok ? "successful\n" : "unsuccessful\n");
         return true;
     }
     else if (cmd == "printShortestEdges") {
         std::string ufid;
         if (!(ss >> ufid)) {
-            std::cout << "unsuccessful\n";
+            *out_ << "unsuccessful\n";
             return true;
         }
         if (!isValidUFID(ufid)) {
-            std::cout << "unsuccessful\n";
+            *out_ << "unsuccessful\n";
             return true;
         }
         handlePrintShortestEdges(ufid);
@@ -502,11 +1013,11 @@ bool CampusCompass::ParseCommand(const std::string& command) {
     else if (cmd == "printStudentZone") {
         std::string ufid;
         if (!(ss >> ufid)) {
-            std::cout << "unsuccessful\n";
+            *out_ << "unsuccessful\n";
             return true;
         }
         if (!isValidUFID(ufid)) {
-            std::cout << "unsuccessful\n";
+            *out_ << "unsuccessful\n";
             return true;
         }
         handlePrintStudentZone(ufid);
@@ -515,18 +1026,118 @@ bool CampusCompass::ParseCommand(const std::string& command) {
     else if (cmd == "verifySchedule") {
         std::string ufid;
         if (!(ss >> ufid)) {
-            std::cout << "unsuccessful\n";
+            *out_ << "unsuccessful\n";
             return true;
         }
         if (!isValidUFID(ufid)) {
-            std::cout << "unsuccessful\n";
+            *out_ << "unsuccessful\n";
             return true;
         }
         handleVerifySchedule(ufid);
         return true;
     }
+    else if (cmd == "reachableWithin") {
+        int loc;
+        if (!(ss >> loc)) {
+            *out_ << "unsuccessful\n";
+            return true;
+        }
+        std::vector<int> budgets;
+        int b;
+        while (ss >> b) {
+            budgets.push_back(b);
+        }
+        handleReachableWithin(loc, budgets);
+        return true;
+    }
+    else if (cmd == "studentReachableWithin") {
+        std::string ufid;
+        if (!(ss >> ufid) || !isValidUFID(ufid)) {
+            *out_ << "unsuccessful\n";
+            return true;
+        }
+        const Student* s = students_.getStudent(ufid);
+        if (!s) {
+            *out_ << "unsuccessful\n";
+            return true;
+        }
+        std::vector<int> budgets;
+        int b;
+        while (ss >> b) {
+            budgets.push_back(b);
+        }
+        handleReachableWithin(s->residenceLocationId, budgets);
+        return true;
+    }
+    else if (cmd == "findCompatibleClasses") {
+        std::string ufid;
+        if (!(ss >> ufid) || !isValidUFID(ufid)) {
+            *out_ << "unsuccessful\n";
+            return true;
+        }
+        handleFindCompatibleClasses(ufid);
+        return true;
+    }
+    else if (cmd == "suggestSchedule") {
+        std::string ufid;
+        int N;
+        if (!(ss >> ufid >> N) || !isValidUFID(ufid) || N < 1 || N > 6) {
+            *out_ << "unsuccessful\n";
+            return true;
+        }
+        // Each course is one token of '|'-separated class codes
+        std::vector<std::vector<std::string>> options;
+        std::string token;
+        while (ss >> token) {
+            std::vector<std::string> codes;
+            std::stringstream ts(token);
+            std::string code;
+            while (std::getline(ts, code, '|')) {
+                codes.push_back(code);
+            }
+            options.push_back(codes);
+        }
+        if (static_cast<int>(options.size()) != N) {
+            *out_ << "unsuccessful\n";
+            return true;
+        }
+        handleSuggestSchedule(ufid, options);
+        return true;
+    }
+    else if (cmd == "memoryUsage") {
+        std::size_t g = graph_.memoryUsage();
+        std::size_t c = catalog_.memoryUsage();
+        std::size_t st = students_.memoryUsage();
+        std::size_t cache = hashMapBytes(distCache_);
+        for (const auto& [src, dist] : distCache_) {
+            (void)src;
+            cache += hashMapBytes(dist);
+        }
+        *out_ << "Memory Usage (bytes): graph " << g
+              << " | classes " << c
+              << " | students " << st
+              << " | cache " << cache
+              << " | total " << (g + c + st + cache) << "\n";
+        return true;
+    }
+    else if (cmd == "reload") {
+        // reload [edges.csv classes.csv]; defaults to the files last loaded
+        std::string edges = edgesPath_, classes = classesPath_;
+        std::string e, c;
+        if (ss >> e) {
+            if (!(ss >> c)) {
+                *out_ << "unsuccessful\n";
+                return true;
+            }
+            edges = e;
+            classes = c;
+        }
+        bool ok = Reload(edges, classes);
+        *out_ << (ok ? "successful\n" : "unsuccessful\n");
+        return true;
+    }
 
     // Unknown command
-    std::cout << "unsuccessful\n";
+    *out_ << "unsuccessful\n";
     return false;
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <iostream>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -19,8 +22,32 @@ public:
     // Parse one command line, execute it, and print required output
     // Returns true if the command keyword was recognized,
     // false if the command keyword itself was invalid.
+    //
+    // Between "begin" and "commit", mutations (insert, remove, dropClass,
+    // replaceClass, removeClass, toggleEdgesClosure) are staged silently
+    // and applied together on commit; if any of them fails the whole
+    // batch is rolled back and commit prints "unsuccessful". "rollback"
+    // discards the staged batch. Queries keep running immediately against
+    // the committed state.
     bool ParseCommand(const std::string& command);
 
+    // Re-read edges/classes CSVs and apply only the differences to the
+    // loaded graph and catalog. Student data and the open/closed state of
+    // surviving edges are kept. Returns false (changing nothing) if either
+    // file can't be read.
+    bool Reload(const std::string& edges_filepath,
+                const std::string& classes_filepath);
+
+    // Bulk-load students from a roster CSV
+    // (Name,UFID,ResidenceLocationID,ClassCode_1,...,ClassCode_N).
+    // Prints "Row <line>: unsuccessful" for every rejected row, then the
+    // number of students loaded. Returns false if the file can't be read.
+    bool LoadStudents(const std::string& path);
+
+    // Redirect command output (defaults to std::cout).
+    // The stream must outlive this object.
+    void SetOutput(std::ostream& out);
+
 private:
     // -----------------------------
     // Internal Data Storage
@@ -28,6 +55,36 @@ private:
     Graph graph_;                 // campus walk graph
     ClassCatalog catalog_;        // all classes + locations
     StudentManager students_;     // all students enrolled in system
+    std::ostream* out_;           // where command output is written
+
+    // -----------------------------
+    // Mutation Batch
+    // -----------------------------
+    bool inBatch_ = false;
+    std::vector<std::pair<std::string, std::string>> staged_;  // (keyword, line)
+
+    static bool isMutation(const std::string& cmd);
+    bool applyMutation(const std::string& cmd,
+                       std::stringstream& ss,
+                       const std::string& command);
+    bool commitBatch();
+
+    // -----------------------------
+    // Travel Time Cache
+    // -----------------------------
+    // Dijkstra distance tables by source, valid for graph_.version()
+    // == distCacheVersion_. Every table has one entry per vertex, so the
+    // cache is bounded by total entries (about 40 bytes each) rather than
+    // by sources: it is dropped wholesale once the graph changes or a new
+    // table would push it past kMaxCachedEntries. The table just computed
+    // is always kept, even on graphs larger than the limit.
+    static constexpr std::size_t kMaxCachedEntries = std::size_t(1) << 21;
+    mutable std::unordered_map<int, std::unordered_map<int, int>> distCache_;
+    mutable std::size_t distCacheEntries_ = 0;
+    mutable std::uint64_t distCacheVersion_ = 0;
+
+    const std::unordered_map<int, int>& distancesFrom(int source) const;
+    int travelTime(int from, int to) const;  // INT_MAX if unreachable
 
     // -----------------------------
     // Validation Helpers
@@ -35,6 +92,7 @@ private:
     bool isValidUFID(const std::string& ufid) const;
     bool isValidName(const std::string& name) const;
     bool isValidClassCode(const std::string& code) const;
+    bool isValidStudent(const Student& s) const;
 
     // -----------------------------
     // Parsing Helpers
@@ -44,14 +102,25 @@ private:
     // -----------------------------
     // CSV Loader Helpers
     // -----------------------------
+    bool readEdges(const std::string& path, std::vector<Graph::EdgeRow>& rows) const;
+    bool readClasses(const std::string& path, std::vector<ClassInfo>& classes) const;
     bool loadEdges(const std::string& path);
     bool loadClasses(const std::string& path);
 
+    // files last loaded, used by a bare "reload"
+    std::string edgesPath_;
+    std::string classesPath_;
+
     // -----------------------------
     // Command-specific helpers
     // -----------------------------
     bool handleInsert(const std::string& fullLine);
+    bool parseInsert(const std::string& fullLine, Student& s) const;
     void handlePrintShortestEdges(const std::string& ufid) const;
     void handlePrintStudentZone(const std::string& ufid) const;
     void handleVerifySchedule(const std::string& ufid) const;
+    void handleReachableWithin(int source, const std::vector<int>& budgets) const;
+    void handleFindCompatibleClasses(const std::string& ufid) const;
+    void handleSuggestSchedule(const std::string& ufid,
+                               const std::vector<std::vector<std::string>>& options) const;
 };
\ No newline at end of file
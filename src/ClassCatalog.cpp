@@ -1,7 +1,69 @@
 #include "ClassCatalog.h"
+#include "MemoryUsage.h"
+
+#include <algorithm>
+
+void ClassCatalog::unindexLocation(int locationId, const std::string& code) {
+    auto lit = byLocation_.find(locationId);
+    if (lit == byLocation_.end()) return;
+    auto& codes = lit->second;
+    codes.erase(std::remove(codes.begin(), codes.end(), code), codes.end());
+    if (codes.empty()) byLocation_.erase(lit);
+}
 
 void ClassCatalog::addClass(const ClassInfo& info) {
-    classes_[info.code] = info;
+    auto it = classes_.find(info.code);
+    if (it != classes_.end()) {
+        // Overwriting: forget the old location first
+        unindexLocation(it->second.locationId, info.code);
+        it->second = info;
+    } else {
+        classes_.emplace(info.code, info);
+    }
+    byLocation_[info.locationId].push_back(info.code);
+    byStartDirty_ = true;
+}
+
+bool ClassCatalog::removeClass(const std::string& code) {
+    auto it = classes_.find(code);
+    if (it == classes_.end()) {
+        return false;
+    }
+    unindexLocation(it->second.locationId, code);
+    classes_.erase(it);
+    byStartDirty_ = true;
+    return true;
+}
+
+int ClassCatalog::syncClasses(const std::vector<ClassInfo>& classes) {
+    int changes = 0;
+
+    std::unordered_map<std::string, const ClassInfo*> wanted;
+    for (const auto& info : classes) {
+        wanted[info.code] = &info;  // last row per code wins, as in addClass
+    }
+
+    std::vector<std::string> gone;
+    for (const auto& [code, info] : classes_) {
+        (void)info;
+        if (!wanted.count(code)) gone.push_back(code);
+    }
+    for (const auto& code : gone) {
+        removeClass(code);
+        ++changes;
+    }
+
+    for (const auto& [code, info] : wanted) {
+        const ClassInfo* cur = getClass(code);
+        if (cur && cur->locationId == info->locationId &&
+            cur->startMinutes == info->startMinutes &&
+            cur->endMinutes == info->endMinutes) {
+            continue;
+        }
+        addClass(*info);
+        ++changes;
+    }
+    return changes;
 }
 
 bool ClassCatalog::hasClass(const std::string& code) const {
@@ -14,4 +76,48 @@ const ClassInfo* ClassCatalog::getClass(const std::string& code) const {
         return nullptr;
     }
     return &it->second;
+}
+
+const std::vector<std::string>* ClassCatalog::classesAt(int locationId) const {
+    auto it = byLocation_.find(locationId);
+    if (it == byLocation_.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+std::vector<const ClassInfo*> ClassCatalog::classesStartingBetween(int lo, int hi) const {
+    if (byStartDirty_) {
+        byStart_.clear();
+        byStart_.reserve(classes_.size());
+        for (const auto& [code, info] : classes_) {
+            (void)code;
+            byStart_.push_back(&info);
+        }
+        std::sort(byStart_.begin(), byStart_.end(), [](const ClassInfo* a, const ClassInfo* b) {
+            if (a->startMinutes != b->startMinutes) return a->startMinutes < b->startMinutes;
+            return a->code < b->code;
+        });
+        byStartDirty_ = false;
+    }
+
+    auto first = std::lower_bound(byStart_.begin(), byStart_.end(), lo,
+                                  [](const ClassInfo* c, int t) { return c->startMinutes < t; });
+    auto last = std::upper_bound(first, byStart_.end(), hi,
+                                 [](int t, const ClassInfo* c) { return t < c->startMinutes; });
+    return std::vector<const ClassInfo*>(first, last);
+}
+
+std::size_t ClassCatalog::memoryUsage() const {
+    std::size_t bytes = hashMapBytes(classes_) + hashMapBytes(byLocation_) +
+                        vectorBytes(byStart_);
+    for (const auto& [code, info] : classes_) {
+        bytes += stringBytes(code) + stringBytes(info.code);
+    }
+    for (const auto& [loc, codes] : byLocation_) {
+        (void)loc;
+        bytes += vectorBytes(codes);
+        for (const auto& c : codes) bytes += stringBytes(c);
+    }
+    return bytes;
 }
\ No newline at end of file
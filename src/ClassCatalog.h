@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 struct ClassInfo {
     std::string code;
@@ -17,12 +18,40 @@ public:
     // Add or overwrite a class
     void addClass(const ClassInfo& info);
 
+    // Remove a class; returns false if it doesn't exist
+    bool removeClass(const std::string& code);
+
+    // Make the catalog match 'classes': add new codes, overwrite changed
+    // ones, remove missing ones. Returns the number of classes touched.
+    int syncClasses(const std::vector<ClassInfo>& classes);
+
     // Check if a class exists
     bool hasClass(const std::string& code) const;
 
     // Get class info (nullptr if not found)
     const ClassInfo* getClass(const std::string& code) const;
 
+    // Codes of all classes held at a location (nullptr if none)
+    const std::vector<std::string>* classesAt(int locationId) const;
+
+    // Classes with lo <= startMinutes <= hi, ordered by start time
+    // (then code). Backed by a sorted index rebuilt lazily after changes.
+    std::vector<const ClassInfo*> classesStartingBetween(int lo, int hi) const;
+
+    // Estimated heap bytes held by the catalog
+    std::size_t memoryUsage() const;
+
 private:
     std::unordered_map<std::string, ClassInfo> classes_;
+
+    // location id -> codes of the classes held there
+    std::unordered_map<int, std::vector<std::string>> byLocation_;
+
+    // all classes sorted by (startMinutes, code); only valid while
+    // !byStartDirty_
+    mutable std::vector<const ClassInfo*> byStart_;
+    mutable bool byStartDirty_ = true;
+
+    // helper: drop code from byLocation_[locationId]
+    void unindexLocation(int locationId, const std::string& code);
 };
\ No newline at end of file
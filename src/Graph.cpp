@@ -1,73 +1,347 @@
 #include "Graph.h"
+#include "MemoryUsage.h"
+#include "Tracer.h"
 
 #include <queue>
 #include <limits>
 #include <unordered_set>
 #include <functional>
+#include <utility>
+#include <tuple>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+// CPUs the calling thread may run on. New threads inherit the caller's
+// affinity, so a caller pinned to one core (a tenant worker) gets no
+// parallelism from spawning more threads.
+unsigned usableCpus() {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        return static_cast<unsigned>(std::max(1, CPU_COUNT(&set)));
+    }
+#endif
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Run fn(thread, begin, end) over [0, n) on up to 'threads' threads.
+// Work is handed out in chunks from a shared counter, so threads that
+// finish early keep taking chunks instead of idling. Small ranges run
+// inline on the calling thread.
+void parallelChunks(std::size_t n, unsigned threads,
+                    const std::function<void(unsigned, std::size_t, std::size_t)>& fn) {
+    const std::size_t kChunk = 256;
+    if (threads <= 1 || n <= kChunk) {
+        if (n > 0) fn(0, 0, n);
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto work = [&](unsigned t) {
+        while (true) {
+            std::size_t b = next.fetch_add(kChunk, std::memory_order_relaxed);
+            if (b >= n) return;
+            fn(t, b, std::min(n, b + kChunk));
+        }
+    };
+
+    unsigned used = static_cast<unsigned>(std::min<std::size_t>(threads, (n + kChunk - 1) / kChunk));
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < used; ++t) {
+        pool.emplace_back(work, t);
+    }
+    work(0);
+    for (auto& th : pool) th.join();
+}
+
+}  // namespace
+
+int Graph::indexOf(int u) const {
+    auto it = index_.find(u);
+    if (it == index_.end()) return -1;
+    return it->second;
+}
+
+int Graph::addVertex(int u) {
+    auto [it, inserted] = index_.emplace(u, static_cast<int>(ids_.size()));
+    if (inserted) {
+        ids_.push_back(u);
+        adj_.emplace_back();
+    }
+    return it->second;
+}
+
+void Graph::countWeight(int w, int sign) {
+    weightSum_ += sign * static_cast<long long>(w);
+    liveEdges_ += sign;
+    if (w <= 0) nonPositiveEdges_ += sign;
+}
 
 void Graph::addEdge(int u, int v, int w) {
-    adj_[u].emplace_back(v, w, false);
-    adj_[v].emplace_back(u, w, false);
+    int id = static_cast<int>(closed_.size());
+    closed_.push_back(0);
+    edgeIds_.emplace(pairKey(u, v), id);
+
+    int iu = addVertex(u);
+    int iv = addVertex(v);
+    adj_[iu].emplace_back(iv, w, id);
+    adj_[iv].emplace_back(iu, w, id);
+    countWeight(w, +1);
+    ++version_;
+}
+
+void Graph::removeEdgeId(int iu, int iv, int id) {
+    auto unlink = [&](int from) {
+        auto& edges = adj_[from];
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            if (edges[i].id == id) {
+                edges.erase(edges.begin() + i);
+                return;
+            }
+        }
+    };
+    for (const auto& e : adj_[iu]) {
+        if (e.id == id) {
+            countWeight(e.time, -1);
+            break;
+        }
+    }
+    unlink(iu);
+    unlink(iv);
+
+    // If a parallel edge is left between the pair, it takes over the index
+    std::uint64_t key = pairKey(ids_[iu], ids_[iv]);
+    edgeIds_.erase(key);
+    for (const auto& e : adj_[iu]) {
+        if (e.to == iv) {
+            edgeIds_.emplace(key, e.id);
+            break;
+        }
+    }
+}
+
+int Graph::syncEdges(const std::vector<EdgeRow>& rows) {
+    // pair -> every weight the file wants for it; parallel rows are kept,
+    // as in addEdge, so each pair is diffed as a multiset of weights
+    std::unordered_map<std::uint64_t, std::vector<int>> wanted;
+    for (const auto& [u, v, w] : rows) {
+        wanted[pairKey(u, v)].push_back(w);
+    }
+
+    // pair -> live edge ids, each listed once (adj_ holds both directions)
+    std::unordered_map<std::uint64_t, std::vector<int>> existing;
+    std::vector<char> seen(closed_.size(), 0);
+    for (int iu = 0; iu < static_cast<int>(adj_.size()); ++iu) {
+        for (const auto& e : adj_[iu]) {
+            if (seen[e.id]) continue;
+            seen[e.id] = 1;
+            existing[pairKey(ids_[iu], ids_[e.to])].push_back(e.id);
+        }
+    }
+
+    auto takeWeight = [](std::vector<int>& ws, int w) {
+        auto it = std::find(ws.begin(), ws.end(), w);
+        if (it == ws.end()) return false;
+        ws.erase(it);
+        return true;
+    };
+
+    int changes = 0;
+
+    // Existing edges: keep exact matches, reweight the rest while the file
+    // still wants rows for the pair, drop the surplus. Kept and reweighted
+    // edges keep their id and closure state.
+    for (auto& [key, edgeIds] : existing) {
+        int iu = indexOf(static_cast<int>(static_cast<std::uint32_t>(key >> 32)));
+        int iv = indexOf(static_cast<int>(static_cast<std::uint32_t>(key)));
+        auto wit = wanted.find(key);
+        std::vector<int> noRows;
+        std::vector<int>& ws = wit == wanted.end() ? noRows : wit->second;
+
+        std::vector<std::pair<int, int>> unmatched;   // (id, current weight)
+        for (int id : edgeIds) {
+            int time = 0;
+            for (const auto& e : adj_[iu]) {
+                if (e.id == id) {
+                    time = e.time;
+                    break;
+                }
+            }
+            if (!takeWeight(ws, time)) unmatched.emplace_back(id, time);
+        }
+
+        for (const auto& [id, time] : unmatched) {
+            if (ws.empty()) {
+                removeEdgeId(iu, iv, id);
+            } else {
+                int w = ws.back();
+                ws.pop_back();
+                for (int from : {iu, iv}) {
+                    for (auto& e : adj_[from]) {
+                        if (e.id == id) e.time = w;
+                    }
+                }
+                countWeight(time, -1);
+                countWeight(w, +1);
+            }
+            ++changes;
+        }
+    }
+
+    // Whatever is left is new; add in file order
+    for (const auto& [u, v, w] : rows) {
+        auto wit = wanted.find(pairKey(u, v));
+        if (wit == wanted.end() || !takeWeight(wit->second, w)) continue;
+        addEdge(u, v, w);
+        ++changes;
+    }
+
+    if (changes > 0) {
+        ++version_;
+    }
+    return changes;
 }
 
-int Graph::findEdgeIndex(int u, int v) const {
-    auto it = adj_.find(u);
-    if (it == adj_.end()) return -1;
-    const auto& edges = it->second;
-    for (std::size_t i = 0; i < edges.size(); ++i) {
-        if (edges[i].to == v) return static_cast<int>(i);
+void Graph::reorder() {
+    const int n = static_cast<int>(adj_.size());
+    if (n == 0) return;
+
+    // Reverse Cuthill-McKee: BFS each component from a minimum-degree
+    // vertex, visiting neighbours by increasing degree, then reverse.
+    auto degree = [&](int u) { return adj_[u].size(); };
+
+    std::vector<int> byDegree;
+    byDegree.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (!adj_[i].empty()) byDegree.push_back(i);
+    }
+    std::stable_sort(byDegree.begin(), byDegree.end(),
+                     [&](int a, int b) { return degree(a) < degree(b); });
+
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<char> visited(n, 0);
+    std::vector<int> next;
+
+    for (int root : byDegree) {
+        if (visited[root]) continue;
+        visited[root] = 1;
+        std::size_t head = order.size();
+        order.push_back(root);
+
+        while (head < order.size()) {
+            int u = order[head++];
+            next.clear();
+            for (const auto& e : adj_[u]) {
+                if (!visited[e.to]) {
+                    visited[e.to] = 1;
+                    next.push_back(e.to);
+                }
+            }
+            std::stable_sort(next.begin(), next.end(),
+                             [&](int a, int b) { return degree(a) < degree(b); });
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+
+    // Orphaned vertices aren't in 'order' and get no new index
+    const int kept = static_cast<int>(order.size());
+    std::vector<int> newIndex(n, -1);
+    for (int i = 0; i < kept; ++i) newIndex[order[i]] = i;
+
+    std::vector<std::vector<Edge>> newAdj(kept);
+    std::vector<int> newIds(kept);
+    for (int old = 0; old < n; ++old) {
+        int u = newIndex[old];
+        if (u == -1) continue;
+        newIds[u] = ids_[old];
+        newAdj[u] = std::move(adj_[old]);
+        for (auto& e : newAdj[u]) e.to = newIndex[e.to];
+        std::sort(newAdj[u].begin(), newAdj[u].end(),
+                  [](const Edge& a, const Edge& b) { return a.to < b.to; });
     }
-    return -1;
+
+    adj_ = std::move(newAdj);
+    ids_ = std::move(newIds);
+    index_.clear();
+    for (int i = 0; i < kept; ++i) index_[ids_[i]] = i;
+}
+
+std::uint64_t Graph::pairKey(int u, int v) {
+    if (u > v) std::swap(u, v);
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(u)) << 32) |
+           static_cast<std::uint32_t>(v);
+}
+
+int Graph::findEdgeId(int u, int v) const {
+    auto it = edgeIds_.find(pairKey(u, v));
+    if (it == edgeIds_.end()) return -1;
+    return it->second;
 }
 
 void Graph::toggleEdge(int u, int v) {
-    int idxUV = findEdgeIndex(u, v);
-    int idxVU = findEdgeIndex(v, u);
+    int id = findEdgeId(u, v);
+    if (id == -1) return;
+
+    closed_[id] = !closed_[id];
+    ++version_;
+}
 
-    if (idxUV != -1) {
-        adj_[u][idxUV].closed = !adj_[u][idxUV].closed;
+void Graph::toggleEdges(const std::vector<std::pair<int, int>>& pairs) {
+    bool changed = false;
+    for (const auto& [u, v] : pairs) {
+        int id = findEdgeId(u, v);
+        if (id == -1) continue;
+        closed_[id] = !closed_[id];
+        changed = true;
     }
-    if (idxVU != -1) {
-        adj_[v][idxVU].closed = !adj_[v][idxVU].closed;
+    if (changed) {
+        ++version_;
     }
 }
 
 std::string Graph::edgeStatus(int u, int v) const {
-    int idxUV = findEdgeIndex(u, v);
-    if (idxUV == -1) {
+    int id = findEdgeId(u, v);
+    if (id == -1) {
         return "DNE";
     }
-    const Edge& e = adj_.at(u)[idxUV];
-    return e.closed ? "closed" : "open";
+    return closed_[id] ? "closed" : "open";
 }
 
 bool Graph::isConnected(int start, int goal) const {
     if (start == goal) return true;
 
-    std::unordered_set<int> visited;
-    std::queue<int> q;
-
-    if (adj_.find(start) == adj_.end() ||
-        adj_.find(goal)  == adj_.end()) {
+    int s = indexOf(start);
+    int g = indexOf(goal);
+    if (s == -1 || g == -1) {
         return false;
     }
 
-    visited.insert(start);
-    q.push(start);
+    std::vector<char> visited(adj_.size(), 0);
+    std::queue<int> q;
+
+    visited[s] = 1;
+    q.push(s);
 
     while (!q.empty()) {
         int u = q.front();
         q.pop();
 
-        auto it = adj_.find(u);
-        if (it == adj_.end()) continue;
-
-        for (const auto& e : it->second) {
-            if (e.closed) continue;
+        for (const auto& e : adj_[u]) {
+            if (closed_[e.id]) continue;
             int v = e.to;
-            if (!visited.count(v)) {
-                if (v == goal) return true;
-                visited.insert(v);
+            if (!visited[v]) {
+                if (v == g) return true;
+                visited[v] = 1;
                 q.push(v);
             }
         }
@@ -75,65 +349,263 @@ bool Graph::isConnected(int start, int goal) const {
     return false;
 }
 
+void Graph::dijkstraIndexed(int source,
+                            std::vector<int>& dist,
+                            std::vector<int>& parent) const {
+    if (adj_.size() >= kParallelThreshold && nonPositiveEdges_ == 0 &&
+        usableCpus() > 1) {
+        deltaStepping(source, dist, parent);
+        return;
+    }
+
+    const int INF = std::numeric_limits<int>::max();
+
+    dist.assign(adj_.size(), INF);
+    parent.assign(adj_.size(), -1);
+
+    dist[source] = 0;
+
+    // Equal distances are settled in external id order so the parent
+    // tree doesn't depend on how vertices were numbered internally.
+    using Node = std::pair<int, int>;  // (dist, internal index)
+    auto later = [this](const Node& a, const Node& b) {
+        if (a.first != b.first) return a.first > b.first;
+        return ids_[a.second] > ids_[b.second];
+    };
+    std::priority_queue<Node, std::vector<Node>, decltype(later)> pq(later);
+    pq.push({0, source});
+
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+
+        if (d > dist[u]) continue;
+
+        for (const auto& e : adj_[u]) {
+            if (closed_[e.id]) continue; // skip closed edges
+            int v = e.to;
+            int w = e.time;
+            if (dist[u] + w < dist[v]) {
+                dist[v] = dist[u] + w;
+                parent[v] = u;
+                pq.push({dist[v], v});
+            }
+        }
+    }
+}
+
+void Graph::deltaStepping(int source,
+                          std::vector<int>& dist,
+                          std::vector<int>& parent) const {
+    TraceSpan span("deltaStepping");
+
+    const int INF = std::numeric_limits<int>::max();
+    const std::size_t n = adj_.size();
+    const unsigned threads = usableCpus();
+
+    // Bucket width: edges up to delta are "light" and re-relaxed within a
+    // bucket, heavier ones are relaxed once when the bucket is settled.
+    const int delta = static_cast<int>(std::max<long long>(1, weightSum_ / std::max(1, liveEdges_)));
+
+    std::vector<std::atomic<int>> d(n);
+    for (auto& x : d) x.store(INF, std::memory_order_relaxed);
+    d[source].store(0, std::memory_order_relaxed);
+
+    std::vector<std::vector<int>> buckets(1, std::vector<int>{source});
+    std::vector<std::vector<int>> improved(threads);  // per thread, no sharing
+    std::vector<unsigned> queuedIn(n, 0);
+    unsigned phase = 0;
+
+    auto relax = [&](unsigned t, int u, bool light) {
+        int du = d[u].load(std::memory_order_relaxed);
+        for (const auto& e : adj_[u]) {
+            if (closed_[e.id]) continue;
+            if ((e.time <= delta) != light) continue;
+            int nd = du + e.time;
+            int cur = d[e.to].load(std::memory_order_relaxed);
+            while (nd < cur) {
+                if (d[e.to].compare_exchange_weak(cur, nd, std::memory_order_relaxed)) {
+                    improved[t].push_back(e.to);
+                    break;
+                }
+            }
+        }
+    };
+
+    // Move every improved vertex into the bucket of its new distance
+    auto rebucket = [&]() {
+        for (auto& list : improved) {
+            for (int v : list) {
+                std::size_t b = static_cast<std::size_t>(d[v].load(std::memory_order_relaxed) / delta);
+                if (b >= buckets.size()) buckets.resize(b + 1);
+                buckets[b].push_back(v);
+            }
+            list.clear();
+        }
+    };
+
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        std::vector<int> settled;
+
+        while (!buckets[i].empty()) {
+            // Current members only: skip stale entries and duplicates
+            ++phase;
+            std::vector<int> frontier;
+            for (int v : buckets[i]) {
+                if (static_cast<std::size_t>(d[v].load(std::memory_order_relaxed) / delta) != i) continue;
+                if (queuedIn[v] == phase) continue;
+                queuedIn[v] = phase;
+                frontier.push_back(v);
+            }
+            buckets[i].clear();
+
+            parallelChunks(frontier.size(), threads,
+                           [&](unsigned t, std::size_t b, std::size_t e) {
+                for (std::size_t k = b; k < e; ++k) relax(t, frontier[k], true);
+            });
+            settled.insert(settled.end(), frontier.begin(), frontier.end());
+            rebucket();
+        }
+
+        std::sort(settled.begin(), settled.end());
+        settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+        parallelChunks(settled.size(), threads,
+                       [&](unsigned t, std::size_t b, std::size_t e) {
+            for (std::size_t k = b; k < e; ++k) relax(t, settled[k], false);
+        });
+        rebucket();
+    }
+
+    dist.resize(n);
+    for (std::size_t v = 0; v < n; ++v) {
+        dist[v] = d[v].load(std::memory_order_relaxed);
+    }
+
+    // Sequential Dijkstra settles equal distances in external id order, so
+    // with positive weights its parent for v is the tight neighbour u
+    // (dist[u] + w == dist[v]) that comes first by (dist[u], external id).
+    parent.assign(n, -1);
+    parallelChunks(n, threads, [&](unsigned, std::size_t b, std::size_t e) {
+        for (std::size_t v = b; v < e; ++v) {
+            if (static_cast<int>(v) == source || dist[v] == INF) continue;
+            int best = -1;
+            for (const auto& edge : adj_[v]) {
+                if (closed_[edge.id]) continue;
+                int u = edge.to;
+                if (dist[u] == INF || dist[u] + edge.time != dist[v]) continue;
+                if (best == -1 || dist[u] < dist[best] ||
+                    (dist[u] == dist[best] && ids_[u] < ids_[best])) {
+                    best = u;
+                }
+            }
+            parent[v] = best;
+        }
+    });
+}
+
 void Graph::dijkstra(int source,
                      std::unordered_map<int, int>& dist,
                      std::unordered_map<int, int>& parent) const {
+    TraceSpan span("dijkstra");
+
     const int INF = std::numeric_limits<int>::max();
 
     dist.clear();
     parent.clear();
+    dist.reserve(ids_.size());
+    parent.reserve(ids_.size());
+
+    int s = indexOf(source);
+    if (s == -1) {
+        for (int id : ids_) {
+            dist[id] = INF;
+            parent[id] = -1;
+        }
+        return;
+    }
 
-    // Initialize distances to INF
-    for (const auto& [u, edges] : adj_) {
-        (void)edges;
-        dist[u] = INF;
-        parent[u] = -1;
+    std::vector<int> d, p;
+    dijkstraIndexed(s, d, p);
+
+    for (std::size_t i = 0; i < ids_.size(); ++i) {
+        dist[ids_[i]] = d[i];
+        parent[ids_[i]] = (p[i] == -1) ? -1 : ids_[p[i]];
     }
+}
 
-    if (adj_.find(source) == adj_.end()) {
+void Graph::reachableWithin(int source, int budget,
+                            std::unordered_map<int, int>& dist) const {
+    TraceSpan span("reachableWithin");
+
+    dist.clear();
+    int s = indexOf(source);
+    if (budget < 0 || s == -1) {
         return;
     }
 
-    dist[source] = 0;
-    parent[source] = -1;
+    // keyed by internal index; sized by the answer, not the graph
+    std::unordered_map<int, int> best;
+    std::unordered_set<int> settled;
+    best[s] = 0;
 
     using Node = std::pair<int, int>;
     std::priority_queue<Node, std::vector<Node>, std::greater<Node>> pq;
-    pq.push({0, source});
+    pq.push({0, s});
 
     while (!pq.empty()) {
         auto [d, u] = pq.top();
         pq.pop();
 
-        if (d > dist[u]) continue;
+        if (!settled.insert(u).second) continue;
+        dist[ids_[u]] = d;
 
-        auto it = adj_.find(u);
-        if (it == adj_.end()) continue;
+        for (const auto& e : adj_[u]) {
+            if (closed_[e.id]) continue;
+            int nd = d + e.time;
+            if (nd > budget) continue;  // never leave the budget
 
-        for (const auto& e : it->second) {
-            if (e.closed) continue; // skip closed edges
-            int v = e.to;
-            int w = e.time;
-            if (dist[u] != INF && dist[u] + w < dist[v]) {
-                dist[v] = dist[u] + w;
-                parent[v] = u;
-                pq.push({dist[v], v});
+            auto [bit, fresh] = best.emplace(e.to, nd);
+            if (fresh || nd < bit->second) {
+                bit->second = nd;
+                pq.push({nd, e.to});
             }
         }
     }
 }
 
+bool Graph::hasVertex(int u) const {
+    return indexOf(u) != -1;
+}
+
+std::size_t Graph::memoryUsage() const {
+    std::size_t bytes = hashMapBytes(index_) + vectorBytes(ids_) +
+                        vectorBytes(adj_) + vectorBytes(closed_) +
+                        hashMapBytes(edgeIds_);
+    for (const auto& edges : adj_) {
+        bytes += vectorBytes(edges);
+    }
+    return bytes;
+}
+
 int Graph::mstCost(const std::vector<int>& vertices) const {
+    TraceSpan span("mstCost");
+
     if (vertices.empty()) return 0;
 
-    std::unordered_set<int> vset(vertices.begin(), vertices.end());
+    // Vertices that aren't in the graph have no edges and can't change
+    // the cost, so only the internal indices of known ones are kept.
+    std::unordered_set<int> vset;
+    for (int v : vertices) {
+        int i = indexOf(v);
+        if (i != -1) vset.insert(i);
+    }
 
     // Prim's algorithm
     std::unordered_set<int> inMST;
 
     // Start from first vertex
-    int start = vertices[0];
-    if (!vset.count(start)) return 0;
+    int start = indexOf(vertices[0]);
+    if (start == -1) return 0;
 
     using EdgeState = std::tuple<int,int,int>; // (weight, from, to)
     std::priority_queue<EdgeState,
@@ -141,10 +613,8 @@ int Graph::mstCost(const std::vector<int>& vertices) const {
                         std::greater<EdgeState>> pq;
 
     auto addEdgesFrom = [&](int u) {
-        auto it = adj_.find(u);
-        if (it == adj_.end()) return;
-        for (const auto& e : it->second) {
-            if (e.closed) continue;
+        for (const auto& e : adj_[u]) {
+            if (closed_[e.id]) continue;
             int v = e.to;
             if (!vset.count(v)) continue;
             if (inMST.count(v)) continue;
@@ -1,25 +1,57 @@
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <tuple>
+#include <utility>
 
 class Graph {
 public:
+    // Vertices are stored under dense internal indices (0..n-1) assigned
+    // as they are first seen; every public method takes and returns the
+    // external location ids from the CSV.
+    //
+    // Fields stay 32-bit on purpose: an 8-byte {uint16 to, uint8 time,
+    // int32 id} layout measured no faster in Dijkstra (the priority queue
+    // and the dist/closure lookups dominate, not the edge scan) and would
+    // cap maps at 65535 vertices and 255-minute edges.
     struct Edge {
-        int to;
+        int to;     // internal index of the other endpoint
         int time;
-        bool closed;
+        int id;     // undirected edge id, shared by both directions
 
-        Edge(int t, int w, bool c = false) : to(t), time(w), closed(c) {}
+        Edge(int t, int w, int i) : to(t), time(w), id(i) {}
     };
 
     // Add an undirected edge between u and v with weight w (time)
     void addEdge(int u, int v, int w);
 
+    // (u, v, time) as read from edges.csv
+    using EdgeRow = std::tuple<int, int, int>;
+
+    // Make the edge set match 'rows' by delta: edges missing from rows are
+    // removed, reweighted ones updated in place, new ones added. Repeated
+    // rows for a pair are parallel edges, as in a fresh load. Edges that
+    // survive keep their id and open/closed state.
+    // Returns the number of edges added, removed or reweighted.
+    int syncEdges(const std::vector<EdgeRow>& rows);
+
+    // Renumber vertices internally in reverse Cuthill-McKee order and sort
+    // each adjacency list by neighbour, so vertices that are close in the
+    // map are close in memory. Vertices left without any edge (e.g. after
+    // syncEdges removed their last one) are dropped, as if never loaded.
+    // Query results are otherwise unaffected.
+    void reorder();
+
     // Toggle an existing edge between u and v (open/closed)
     void toggleEdge(int u, int v);
 
+    // Toggle every (u, v) pair in order; pairs that don't exist are
+    // skipped. The version is bumped once for the whole batch.
+    void toggleEdges(const std::vector<std::pair<int, int>>& pairs);
+
     // "open", "closed", or "DNE"
     std::string edgeStatus(int u, int v) const;
 
@@ -29,19 +61,88 @@ public:
     // Dijkstra: shortest paths from source using only open edges
     // dist[node] = min time from source
     // parent[node] = previous node on shortest path (or -1 for source)
+    // Graphs with at least kParallelThreshold vertices and only positive
+    // weights are solved with parallel delta-stepping instead, when the
+    // calling thread may run on more than one CPU; dist and parent come
+    // out identical, ties included.
     void dijkstra(int source,
                   std::unordered_map<int, int>& dist,
                   std::unordered_map<int, int>& parent) const;
 
+    // Bounded Dijkstra: dist[node] = min time from source for every node
+    // reachable within 'budget' over open edges. Nodes beyond the budget
+    // are never visited, so the cost depends on the answer size only.
+    void reachableWithin(int source, int budget,
+                         std::unordered_map<int, int>& dist) const;
+
+    // True if u is an endpoint of at least one edge
+    bool hasVertex(int u) const;
+
     // Minimum spanning tree cost on subgraph induced by 'vertices'
     // Only open edges with both endpoints in 'vertices' are considered.
     // Assumes the subgraph is connected (as per project spec).
     int mstCost(const std::vector<int>& vertices) const;
 
+    // Monotonic version of the graph state. Bumped whenever an edge is
+    // added, removed, reweighted or toggled, so anything derived from a
+    // query result (e.g. CampusCompass's travel time cache) can tell
+    // whether it is still current. This is a staleness check only, not
+    // snapshot isolation: queries always read the live graph.
+    std::uint64_t version() const { return version_; }
+
+    // Estimated heap bytes held by the graph
+    std::size_t memoryUsage() const;
+
+    static constexpr std::size_t kParallelThreshold = 50000;
+
 private:
-    // adjacency list: node id -> edges
-    std::unordered_map<int, std::vector<Edge>> adj_;
+    // external location id <-> internal index
+    std::unordered_map<int, int> index_;
+    std::vector<int> ids_;
+
+    // adjacency list: internal index -> edges
+    std::vector<std::vector<Edge>> adj_;
+
+    // closure flag per edge id (both directions read the same flag)
+    std::vector<char> closed_;
+
+    // unordered vertex pair -> edge id (first edge added between them)
+    std::unordered_map<std::uint64_t, int> edgeIds_;
+
+    // current graph version (see version())
+    std::uint64_t version_ = 0;
+
+    // weight statistics over live edges, for choosing a shortest path
+    // engine and the delta-stepping bucket width
+    long long weightSum_ = 0;
+    int liveEdges_ = 0;
+    int nonPositiveEdges_ = 0;
+    void countWeight(int w, int sign);
+
+    // helper: order-independent key for the pair (u, v)
+    static std::uint64_t pairKey(int u, int v);
+
+    // helper: edge id between u and v; returns -1 if not found
+    int findEdgeId(int u, int v) const;
+
+    // helper: internal index of external id u; returns -1 if not found
+    int indexOf(int u) const;
+
+    // helper: internal index of external id u, adding it if new
+    int addVertex(int u);
+
+    // helper: unlink edge id between internal indices iu and iv
+    void removeEdgeId(int iu, int iv, int id);
+
+    // Dijkstra over internal indices; dist/parent are sized to the graph,
+    // unreachable nodes keep INT_MAX / -1.
+    void dijkstraIndexed(int source,
+                         std::vector<int>& dist,
+                         std::vector<int>& parent) const;
 
-    // helper: find edge index in adj_[u] that goes to v; returns -1 if not found
-    int findEdgeIndex(int u, int v) const;
+    // Delta-stepping over internal indices (positive weights only);
+    // same contract as dijkstraIndexed.
+    void deltaStepping(int source,
+                       std::vector<int>& dist,
+                       std::vector<int>& parent) const;
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Rough heap footprint estimates for per-tenant memory accounting.
+// These count what the containers allocate for their own bookkeeping
+// (buckets, nodes, arrays); callers add the heap owned by the elements.
+
+// Heap owned by a string beyond its inline (SSO) buffer
+inline std::size_t stringBytes(const std::string& s) {
+    return s.capacity() > 15 ? s.capacity() + 1 : 0;
+}
+
+// Bucket array + one node per element (next pointer + cached hash)
+template <typename HashMap>
+std::size_t hashMapBytes(const HashMap& m) {
+    return m.bucket_count() * sizeof(void*) +
+           m.size() * (sizeof(typename HashMap::value_type) + 2 * sizeof(void*));
+}
+
+template <typename T>
+std::size_t vectorBytes(const std::vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
\ No newline at end of file
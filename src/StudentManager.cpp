@@ -1,16 +1,56 @@
 #include "StudentManager.h"
+#include "MemoryUsage.h"
 
 #include <algorithm>
 
+// -----------------------------
+// Enrollment index helpers
+// -----------------------------
+void StudentManager::enroll(const Student& s) {
+    for (const auto& code : s.classes) {
+        enrolled_[code].insert(s.ufid);
+    }
+}
+
+void StudentManager::unenroll(const Student& s) {
+    for (const auto& code : s.classes) {
+        auto it = enrolled_.find(code);
+        if (it == enrolled_.end()) continue;
+        it->second.erase(s.ufid);
+        if (it->second.empty()) {
+            enrolled_.erase(it);
+        }
+    }
+}
+
+// Drop s from classCode's enrollment set unless s still lists it
+// (a schedule may name the same class more than once)
+void StudentManager::unenrollIfGone(const Student& s, const std::string& classCode) {
+    if (std::find(s.classes.begin(), s.classes.end(), classCode) != s.classes.end()) {
+        return;
+    }
+    auto it = enrolled_.find(classCode);
+    if (it == enrolled_.end()) return;
+    it->second.erase(s.ufid);
+    if (it->second.empty()) {
+        enrolled_.erase(it);
+    }
+}
+
 bool StudentManager::hasStudent(const std::string& ufid) const {
     return students_.find(ufid) != students_.end();
 }
 
+void StudentManager::reserve(std::size_t n) {
+    students_.reserve(students_.size() + n);
+}
+
 bool StudentManager::addStudent(const Student& s) {
-    if (hasStudent(s.ufid)) {
+    auto [it, inserted] = students_.emplace(s.ufid, s);
+    if (!inserted) {
         return false;
     }
-    students_[s.ufid] = s;
+    enroll(it->second);
     return true;
 }
 
@@ -19,6 +59,7 @@ bool StudentManager::removeStudent(const std::string& ufid) {
     if (it == students_.end()) {
         return false;
     }
+    unenroll(it->second);
     students_.erase(it);
     return true;
 }
@@ -36,6 +77,7 @@ bool StudentManager::dropClass(const std::string& ufid, const std::string& class
     }
 
     s.classes.erase(cit);
+    unenrollIfGone(s, classCode);
 
     // If student now has 0 classes, remove them entirely
     if (s.classes.empty()) {
@@ -65,32 +107,36 @@ bool StudentManager::replaceClass(const std::string& ufid,
     }
 
     *fromIt = classCodeTo;
+    unenrollIfGone(s, classCodeFrom);
+    enrolled_[classCodeTo].insert(s.ufid);
     return true;
 }
 
 int StudentManager::removeClassFromAll(const std::string& classCode) {
-    int count = 0;
+    auto eit = enrolled_.find(classCode);
+    if (eit == enrolled_.end()) {
+        return 0;
+    }
 
-    for (auto it = students_.begin(); it != students_.end();) {
-        Student& s = it->second;
+    // Take the enrollment set out first; nobody has the class afterwards
+    std::unordered_set<std::string> ufids = std::move(eit->second);
+    enrolled_.erase(eit);
 
-        bool hadClass = false;
+    int count = 0;
+
+    for (const auto& ufid : ufids) {
+        auto it = students_.find(ufid);
+        if (it == students_.end()) continue;
 
-        auto& vec = s.classes;
+        auto& vec = it->second.classes;
         auto newEnd = std::remove(vec.begin(), vec.end(), classCode);
-        if (newEnd != vec.end()) {
-            hadClass = true;
-            vec.erase(newEnd, vec.end());
-        }
+        if (newEnd == vec.end()) continue;
 
-        if (hadClass) {
-            ++count;
-        }
+        vec.erase(newEnd, vec.end());
+        ++count;
 
         if (vec.empty()) {
-            it = students_.erase(it);
-        } else {
-            ++it;
+            students_.erase(it);
         }
     }
 
@@ -105,10 +151,16 @@ const Student* StudentManager::getStudent(const std::string& ufid) const {
     return &it->second;
 }
 
-Student* StudentManager::getStudentMutable(const std::string& ufid) {
-    auto it = students_.find(ufid);
-    if (it == students_.end()) {
-        return nullptr;
+std::size_t StudentManager::memoryUsage() const {
+    std::size_t bytes = hashMapBytes(students_) + hashMapBytes(enrolled_);
+    for (const auto& [ufid, s] : students_) {
+        bytes += stringBytes(ufid) + stringBytes(s.name) + stringBytes(s.ufid) +
+                 vectorBytes(s.classes);
+        for (const auto& c : s.classes) bytes += stringBytes(c);
     }
-    return &it->second;
+    for (const auto& [code, ufids] : enrolled_) {
+        bytes += stringBytes(code) + hashMapBytes(ufids);
+        for (const auto& u : ufids) bytes += stringBytes(u);
+    }
+    return bytes;
 }
\ No newline at end of file
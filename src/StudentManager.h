@@ -2,6 +2,7 @@
 
 #include "Student.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 
 class StudentManager {
@@ -10,6 +11,9 @@ public:
 
     bool hasStudent(const std::string& ufid) const;
 
+    // Pre-size the student table for about n more students
+    void reserve(std::size_t n);
+
     // Add a new student; returns false if UFID already exists
     bool addStudent(const Student& s);
 
@@ -31,15 +35,26 @@ public:
     // Remove a class from all students
     // - Again, if a student ends up with 0 classes, they are removed
     // - Returns the number of students that had this class removed
+    // - Only touches students actually enrolled in classCode
     int removeClassFromAll(const std::string& classCode);
 
     // Read-only lookup
+    // (there is deliberately no mutable lookup: schedules must change
+    //  through the methods above so the enrollment index stays in sync)
     const Student* getStudent(const std::string& ufid) const;
 
-    // Mutable lookup 
-    Student* getStudentMutable(const std::string& ufid);
+    // Estimated heap bytes held by all student records
+    std::size_t memoryUsage() const;
 
 private:
     // key: UFID (string)
     std::unordered_map<std::string, Student> students_;
+
+    // key: class code, value: UFIDs of students taking that class
+    std::unordered_map<std::string, std::unordered_set<std::string>> enrolled_;
+
+    // helpers to keep enrolled_ in sync with a student's class list
+    void enroll(const Student& s);
+    void unenroll(const Student& s);
+    void unenrollIfGone(const Student& s, const std::string& classCode);
 };
\ No newline at end of file
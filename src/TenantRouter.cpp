@@ -0,0 +1,151 @@
+#include "TenantRouter.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// CPUs this process may run on, in order; empty when unknown. Tenants are
+// spread over these rather than 0..hardware_concurrency(), which may lie
+// outside the mask (e.g. under taskset).
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    return cpus;
+}
+
+} // namespace
+
+// -----------------------------
+// Worker
+// -----------------------------
+void TenantRouter::workerLoop(Tenant& t, int cpu) {
+#ifdef __linux__
+    // Pin the tenant to one core so its data stays in that core's caches;
+    // if that fails the worker still runs, just unpinned
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0) {
+            std::cerr << "tenant worker not pinned to CPU " << cpu << ": "
+                      << std::strerror(rc) << "\n";
+        }
+    }
+#else
+    (void)cpu;
+#endif
+
+    while (true) {
+        std::packaged_task<std::string()> job;
+        {
+            std::unique_lock<std::mutex> lock(t.mutex);
+            t.ready.wait(lock, [&] { return t.stopping || !t.jobs.empty(); });
+            if (t.jobs.empty()) return;  // stopping and drained
+            job = std::move(t.jobs.front());
+            t.jobs.pop_front();
+        }
+        job();
+    }
+}
+
+std::future<std::string> TenantRouter::enqueue(Tenant& t,
+                                               std::packaged_task<std::string()> job) {
+    std::future<std::string> result = job.get_future();
+    {
+        std::lock_guard<std::mutex> lock(t.mutex);
+        t.jobs.push_back(std::move(job));
+    }
+    t.ready.notify_one();
+    return result;
+}
+
+// -----------------------------
+// Tenants
+// -----------------------------
+bool TenantRouter::addTenant(const std::string& name, const std::string& data_dir) {
+    if (name.empty() || tenants_.count(name)) {
+        return false;
+    }
+
+    auto tenant = std::make_unique<Tenant>();
+    Tenant& t = *tenant;
+
+    std::vector<int> cpus = allowedCpus();
+    int cpu = cpus.empty() ? -1 : cpus[tenants_.size() % cpus.size()];
+    t.worker = std::thread(workerLoop, std::ref(t), cpu);
+    tenants_.emplace(name, std::move(tenant));
+
+    // Load on the worker so the tenant's memory is first touched there
+    std::packaged_task<std::string()> load([&t, data_dir] {
+        t.compass.SetOutput(t.output);
+        bool ok = t.compass.ParseCSV(data_dir + "/data/edges.csv",
+                                     data_dir + "/data/classes.csv");
+        return std::string(ok ? "successful" : "unsuccessful");
+    });
+    if (enqueue(t, std::move(load)).get() != "successful") {
+        return false;
+    }
+    return true;
+}
+
+std::future<std::string> TenantRouter::submit(const std::string& line) {
+    // "@<tenant> <command>"
+    Tenant* t = nullptr;
+    std::string command;
+
+    if (!line.empty() && line[0] == '@') {
+        std::size_t space = line.find(' ');
+        std::string name = line.substr(1, space == std::string::npos ? std::string::npos
+                                                                     : space - 1);
+        auto it = tenants_.find(name);
+        if (it != tenants_.end()) {
+            t = it->second.get();
+            command = (space == std::string::npos) ? "" : line.substr(space + 1);
+        }
+    }
+
+    if (!t) {
+        std::promise<std::string> failed;
+        failed.set_value("unsuccessful\n");
+        return failed.get_future();
+    }
+
+    std::packaged_task<std::string()> job([t, command] {
+        t->output.str("");
+        t->output.clear();
+        t->compass.ParseCommand(command);
+        return t->output.str();
+    });
+    return enqueue(*t, std::move(job));
+}
+
+TenantRouter::~TenantRouter() {
+    for (auto& [name, t] : tenants_) {
+        (void)name;
+        {
+            std::lock_guard<std::mutex> lock(t->mutex);
+            t->stopping = true;
+        }
+        t->ready.notify_one();
+    }
+    for (auto& [name, t] : tenants_) {
+        (void)name;
+        if (t->worker.joinable()) t->worker.join();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "CampusCompass.h"
+
+// Serves several independent campuses from one process.
+// Each tenant owns its CampusCompass and a dedicated worker thread; the
+// tenant's data is only ever touched from that thread, so tenants share
+// nothing and never contend with each other.
+class TenantRouter {
+public:
+    TenantRouter() = default;
+    ~TenantRouter();
+
+    TenantRouter(const TenantRouter&) = delete;
+    TenantRouter& operator=(const TenantRouter&) = delete;
+
+    // Start a tenant and load <data_dir>/data/edges.csv and classes.csv
+    // on its worker. Returns false if the name is taken or loading fails.
+    bool addTenant(const std::string& name, const std::string& data_dir);
+
+    // Route one "@<tenant> <command>" line to its tenant.
+    // The future yields everything the command printed; lines without a
+    // known tenant prefix yield "unsuccessful".
+    std::future<std::string> submit(const std::string& line);
+
+private:
+    struct Tenant {
+        CampusCompass compass;
+        std::ostringstream output;   // compass output, read back per command
+        std::thread worker;
+
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<std::packaged_task<std::string()>> jobs;
+        bool stopping = false;
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<Tenant>> tenants_;
+
+    static void workerLoop(Tenant& t, int cpu);
+    static std::future<std::string> enqueue(Tenant& t,
+                                            std::packaged_task<std::string()> job);
+};
\ No newline at end of file
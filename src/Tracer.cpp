@@ -0,0 +1,157 @@
+#include "Tracer.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    std::string name;
+    double startUs;
+    double durUs;
+};
+
+struct ThreadBuffer {
+    int tid;
+    std::vector<TraceEvent> events;
+    unsigned long long dropped = 0;   // spans past kMaxEventsPerThread
+};
+
+std::atomic<bool> gEnabled{false};
+std::atomic<unsigned> gSampleEvery{1};
+std::atomic<unsigned long long> gCommandCount{0};
+
+// Registry of every thread's buffer. The mutex is only taken when a
+// thread records its first event and at export.
+std::mutex gRegistryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> gRegistry;
+
+const auto gEpoch = std::chrono::steady_clock::now();
+
+// true while a sampled command runs on this thread
+thread_local bool tSampled = false;
+
+// TraceCommands currently open on this thread; only the outermost one
+// counts towards sampling
+thread_local int tCommandDepth = 0;
+
+double nowUs() {
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - gEpoch).count();
+}
+
+ThreadBuffer& threadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto b = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        b->tid = static_cast<int>(gRegistry.size()) + 1;
+        gRegistry.push_back(b);
+        return b;
+    }();
+    return *buffer;
+}
+
+void record(std::string name, double startUs) {
+    ThreadBuffer& buffer = threadBuffer();
+    if (buffer.events.size() >= Tracer::kMaxEventsPerThread) {
+        ++buffer.dropped;
+        return;
+    }
+    buffer.events.push_back({std::move(name), startUs, nowUs() - startUs});
+}
+
+void writeJsonString(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+        else out << c;
+    }
+    out << '"';
+}
+
+}  // namespace
+
+// -----------------------------
+// Tracer
+// -----------------------------
+void Tracer::enable(unsigned sampleEvery) {
+    gSampleEvery.store(sampleEvery == 0 ? 1 : sampleEvery);
+    gEnabled.store(true);
+}
+
+bool Tracer::enabled() {
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+bool Tracer::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : gRegistry) {
+        for (const auto& e : buffer->events) {
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << "{\"name\":";
+            writeJsonString(out, e.name);
+            out << ",\"ph\":\"X\",\"ts\":" << e.startUs
+                << ",\"dur\":" << e.durUs
+                << ",\"pid\":1,\"tid\":" << buffer->tid << "}";
+        }
+    }
+    unsigned long long dropped = 0;
+    for (const auto& buffer : gRegistry) {
+        dropped += buffer->dropped;
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\""
+        << ",\"otherData\":{\"droppedEvents\":" << dropped << "}}\n";
+    return static_cast<bool>(out);
+}
+
+// -----------------------------
+// TraceCommand
+// -----------------------------
+TraceCommand::TraceCommand() : sampled_(false), startUs_(0) {
+    // nested commands join the outer one, sampled or not
+    if (tCommandDepth++ > 0 || !Tracer::enabled()) return;
+
+    unsigned long long n = gCommandCount.fetch_add(1, std::memory_order_relaxed);
+    if (n % gSampleEvery.load(std::memory_order_relaxed) != 0) return;
+
+    sampled_ = true;
+    tSampled = true;
+    startUs_ = nowUs();
+}
+
+TraceCommand::~TraceCommand() {
+    --tCommandDepth;
+    if (!sampled_) return;
+    record(name_.empty() ? "command" : name_, startUs_);
+    tSampled = false;
+}
+
+void TraceCommand::setName(const std::string& name) {
+    if (sampled_) name_ = name;
+}
+
+// -----------------------------
+// TraceSpan
+// -----------------------------
+TraceSpan::TraceSpan(const char* name) : name_(name), startUs_(-1) {
+    if (tSampled) startUs_ = nowUs();
+}
+
+TraceSpan::~TraceSpan() {
+    if (startUs_ >= 0) record(name_, startUs_);
+}
\ No newline at end of file
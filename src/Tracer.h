@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Optional per-command tracing, exported as Chrome trace-event JSON
+// (loadable in Perfetto or chrome://tracing).
+//
+// A TraceCommand marks one command; whether it is recorded is decided
+// there by sampling. TraceSpans opened while a sampled command is running
+// on the same thread are recorded as nested spans. Each thread appends to
+// its own buffer, so recording takes no locks. When tracing is off, or the
+// command wasn't sampled, a span costs a thread-local flag check.
+//
+// Spans are kept in memory until export, so each thread keeps at most
+// kMaxEventsPerThread of them; later ones are dropped and counted, and
+// the count is written with the trace. Lower the sampling rate if a
+// long-running trace reports drops.
+class Tracer {
+public:
+    static constexpr std::size_t kMaxEventsPerThread = std::size_t(1) << 18;
+
+    // Start tracing 1 in every 'sampleEvery' commands (1 = all of them)
+    static void enable(unsigned sampleEvery);
+
+    static bool enabled();
+
+    // Write everything recorded so far. Call once recording threads are
+    // idle (e.g. at exit). Returns false if the file can't be written.
+    static bool writeChromeTrace(const std::string& path);
+};
+
+class TraceCommand {
+public:
+    TraceCommand();
+    ~TraceCommand();
+
+    // Name the command's span (the command keyword, once it is parsed)
+    void setName(const std::string& name);
+
+    TraceCommand(const TraceCommand&) = delete;
+    TraceCommand& operator=(const TraceCommand&) = delete;
+
+private:
+    bool sampled_;
+    std::string name_;
+    double startUs_;
+};
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    double startUs_;   // < 0 when not recording
+};
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "Workload.h"
+
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// -----------------------------
+// Output hash
+// -----------------------------
+std::uint64_t HashOutput(const std::string& output) {
+    std::uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : output) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// -----------------------------
+// Recorder
+// -----------------------------
+WorkloadRecorder::WorkloadRecorder(const std::string& trace_filepath)
+    : trace_(trace_filepath), start_(std::chrono::steady_clock::now()) {}
+
+bool WorkloadRecorder::isOpen() const {
+    return trace_.is_open();
+}
+
+void WorkloadRecorder::run(CampusCompass& compass, const std::string& command,
+                           std::ostream& out) {
+    auto now = std::chrono::steady_clock::now();
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_).count();
+
+    buffer_.str("");
+    buffer_.clear();
+    compass.SetOutput(buffer_);
+    compass.ParseCommand(command);
+    compass.SetOutput(out);
+
+    const std::string output = buffer_.str();
+    out << output;
+
+    trace_ << ns << '\t' << std::hex << HashOutput(output) << std::dec
+           << '\t' << command << '\n';
+}
+
+// -----------------------------
+// Replayer
+// -----------------------------
+WorkloadReplayer::WorkloadReplayer(double speed) : speed_(speed) {}
+
+bool WorkloadReplayer::replay(CampusCompass& compass,
+                              const std::string& trace_filepath,
+                              std::ostream& report) {
+    std::ifstream trace(trace_filepath);
+    if (!trace.is_open()) {
+        report << "unsuccessful\n";
+        return false;
+    }
+
+    struct Entry {
+        long long ns;
+        std::uint64_t hash;
+        std::string command;
+    };
+
+    // Load the whole trace first so file I/O isn't timed
+    std::vector<Entry> entries;
+    std::string line;
+    while (std::getline(trace, line)) {
+        std::size_t t1 = line.find('\t');
+        std::size_t t2 = (t1 == std::string::npos) ? t1 : line.find('\t', t1 + 1);
+        if (t2 == std::string::npos) {
+            report << "unsuccessful\n";
+            return false;
+        }
+        Entry e;
+        const char* begin = line.data();
+        auto [nsEnd, nsErr] = std::from_chars(begin, begin + t1, e.ns);
+        auto [hashEnd, hashErr] = std::from_chars(begin + t1 + 1, begin + t2, e.hash, 16);
+        if (nsErr != std::errc() || nsEnd != begin + t1 ||
+            hashErr != std::errc() || hashEnd != begin + t2) {
+            report << "unsuccessful\n";
+            return false;
+        }
+        e.command = line.substr(t2 + 1);
+        entries.push_back(std::move(e));
+    }
+
+    std::ostringstream buffer;
+    compass.SetOutput(buffer);
+
+    std::vector<long long> latencies;
+    latencies.reserve(entries.size());
+    int divergent = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const Entry& e = entries[i];
+
+        if (speed_ > 0) {
+            auto due = start + std::chrono::nanoseconds(
+                static_cast<long long>(static_cast<double>(e.ns) / speed_));
+            std::this_thread::sleep_until(due);
+        }
+
+        buffer.str("");
+        buffer.clear();
+
+        auto t0 = std::chrono::steady_clock::now();
+        compass.ParseCommand(e.command);
+        auto t1 = std::chrono::steady_clock::now();
+
+        latencies.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+        if (HashOutput(buffer.str()) != e.hash) {
+            ++divergent;
+            report << "Divergence at command " << (i + 1) << ": " << e.command << "\n";
+        }
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    compass.SetOutput(std::cout);
+
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentileUs = [&](double p) {
+        if (latencies.empty()) return 0.0;
+        std::size_t idx = static_cast<std::size_t>(p * (latencies.size() - 1) + 0.5);
+        return latencies[idx] / 1000.0;
+    };
+
+    report << std::fixed << std::setprecision(3);
+    report << "Commands: " << entries.size() << "\n";
+    report << "Elapsed (ms): " << seconds * 1000.0 << "\n";
+    report << "Throughput (commands/s): "
+           << (seconds > 0 ? entries.size() / seconds : 0.0) << "\n";
+    report << "Latency (us): p50 " << percentileUs(0.50)
+           << " | p90 " << percentileUs(0.90)
+           << " | p99 " << percentileUs(0.99)
+           << " | max " << percentileUs(1.0) << "\n";
+    report << "Divergent Outputs: " << divergent << "\n";
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#include "CampusCompass.h"
+
+// Trace file format: one command per line,
+//   <nanoseconds since recording start>\t<output hash (hex)>\t<command>
+// where the hash is FNV-1a (64-bit) over everything the command printed.
+
+class WorkloadRecorder {
+public:
+    explicit WorkloadRecorder(const std::string& trace_filepath);
+
+    bool isOpen() const;
+
+    // Run one command, forward its output to 'out' and log it to the trace
+    void run(CampusCompass& compass, const std::string& command, std::ostream& out);
+
+private:
+    std::ofstream trace_;
+    std::chrono::steady_clock::time_point start_;
+    std::ostringstream buffer_;
+};
+
+class WorkloadReplayer {
+public:
+    // speed <= 0: as fast as possible
+    // speed  > 0: original pacing, compressed by this factor (1 = real time)
+    explicit WorkloadReplayer(double speed = 0.0);
+
+    // Drive every traced command through compass and print a report
+    // (throughput, latency percentiles, output divergences) to 'report'.
+    // Returns false if the trace can't be read.
+    bool replay(CampusCompass& compass, const std::string& trace_filepath,
+                std::ostream& report);
+
+private:
+    double speed_;
+};
+
+// FNV-1a (64-bit) of a command's output
+std::uint64_t HashOutput(const std::string& output);
\ No newline at end of file
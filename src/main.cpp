@@ -1,10 +1,157 @@
+#include <charconv>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 #include "CampusCompass.h"
+#include "TenantRouter.h"
+#include "Tracer.h"
+#include "Workload.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
 
 using namespace std;
 
-int main() {
+static bool stdinIsTerminal() {
+#if defined(__unix__) || defined(__APPLE__)
+    return isatty(STDIN_FILENO);
+#else
+    return true;
+#endif
+}
+
+// Multi-campus mode: one worker per tenant, outputs written in input order
+static int runTenants(const vector<pair<string, string>>& tenants) {
+    TenantRouter router;
+    for (const auto& [name, dir] : tenants) {
+        if (!router.addTenant(name, dir)) {
+            cout << "unsuccessful" << endl;
+            return 0;
+        }
+    }
+
+    // Tenants run concurrently; a bounded window of pending results keeps
+    // output ordered without letting one slow tenant buffer everything.
+    const size_t kMaxInFlight = 4096;
+    deque<future<string>> pending;
+
+    int no_of_lines;
+    cin >> no_of_lines;
+    cin.ignore();
+
+    string command;
+    for (int i = 0; i < no_of_lines; i++) {
+        getline(cin, command);
+        pending.push_back(router.submit(command));
+        if (pending.size() >= kMaxInFlight) {
+            cout << pending.front().get();
+            pending.pop_front();
+        }
+    }
+    while (!pending.empty()) {
+        cout << pending.front().get();
+        pending.pop_front();
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Stop stdio from syncing with C streams. On a terminal cout stays
+    // tied to cin so each result shows before the next command is read;
+    // piped or redirected input also skips that flush before every read.
+    ios::sync_with_stdio(false);
+    if (!stdinIsTerminal()) {
+        cin.tie(nullptr);
+    }
+
+    // Options:
+    //   --students <roster.csv>  preload students before the command stream
+    //   --record <trace>         log every command with timestamp + output hash
+    //   --replay <trace>         replay a recorded trace instead of reading stdin
+    //   --speed <factor>         replay pacing (0 = as fast as possible)
+    //   --tenant <name>=<dir>    serve <dir>/data/*.csv as tenant <name>;
+    //                            commands are then routed by "@<name> " prefix;
+    //                            not combined with --students/--record/--replay
+    //   --trace <trace.json>     write per-command spans as Chrome trace JSON
+    //   --trace-sample <N>       trace 1 in every N commands (default 1)
+    string rosterPath, recordPath, replayPath, tracePath;
+    vector<pair<string, string>> tenants;
+    double speed = 0.0;
+    unsigned traceSample = 1;
+
+    // Every option takes a value; a missing or malformed one is an error
+    // rather than silently running with the default.
+    auto parseNumber = [](const char* text, auto& value) {
+        const char* end = text + char_traits<char>::length(text);
+        auto [ptr, ec] = from_chars(text, end, value);
+        return ec == errc() && ptr == end;
+    };
+
+    for (int i = 1; i < argc; i++) {
+        string opt = argv[i];
+        if (i + 1 >= argc) {
+            cout << "unsuccessful" << endl;
+            return 0;
+        }
+        const char* value = argv[++i];
+        if (opt == "--students") {
+            rosterPath = value;
+        } else if (opt == "--record") {
+            recordPath = value;
+        } else if (opt == "--replay") {
+            replayPath = value;
+        } else if (opt == "--speed") {
+            if (!parseNumber(value, speed) || speed < 0) {
+                cout << "unsuccessful" << endl;
+                return 0;
+            }
+        } else if (opt == "--tenant") {
+            string spec = value;
+            size_t eq = spec.find('=');
+            if (eq == string::npos) {
+                cout << "unsuccessful" << endl;
+                return 0;
+            }
+            tenants.emplace_back(spec.substr(0, eq), spec.substr(eq + 1));
+        } else if (opt == "--trace") {
+            tracePath = value;
+        } else if (opt == "--trace-sample") {
+            if (!parseNumber(value, traceSample)) {
+                cout << "unsuccessful" << endl;
+                return 0;
+            }
+        } else {
+            cout << "unsuccessful" << endl;
+            return 0;
+        }
+    }
+
+    // Declared before any CampusCompass or tenant so the trace is written
+    // on every exit path, after all workers have stopped.
+    struct TraceWriter {
+        string path;
+        ~TraceWriter() {
+            if (!path.empty()) Tracer::writeChromeTrace(path);
+        }
+    } traceWriter{tracePath};
+    if (!tracePath.empty()) {
+        Tracer::enable(traceSample);
+    }
+
+    if (!tenants.empty()) {
+        // Roster, record and replay apply to a single campus
+        if (!rosterPath.empty() || !recordPath.empty() || !replayPath.empty()) {
+            cout << "unsuccessful" << endl;
+            return 0;
+        }
+        return runTenants(tenants);
+    }
+
     CampusCompass compass;
 
     // Load CSV data
@@ -13,6 +160,28 @@ int main() {
         return 0;
     }
 
+    if (!rosterPath.empty()) {
+        // Row failures go to stderr so stdout only carries command results
+        compass.SetOutput(cerr);
+        compass.LoadStudents(rosterPath);
+        compass.SetOutput(cout);
+    }
+
+    if (!replayPath.empty()) {
+        WorkloadReplayer replayer(speed);
+        replayer.replay(compass, replayPath, cout);
+        return 0;
+    }
+
+    unique_ptr<WorkloadRecorder> recorder;
+    if (!recordPath.empty()) {
+        recorder = make_unique<WorkloadRecorder>(recordPath);
+        if (!recorder->isOpen()) {
+            cout << "unsuccessful" << endl;
+            return 0;
+        }
+    }
+
     int no_of_lines;
     cin >> no_of_lines;
     cin.ignore();
@@ -20,7 +189,11 @@ int main() {
     string command;
     for (int i = 0; i < no_of_lines; i++) {
         getline(cin, command);
-        compass.ParseCommand(command);
+        if (recorder) {
+            recorder->run(compass, command, cout);
+        } else {
+            compass.ParseCommand(command);
+        }
     }
 
     return 0;